@@ -0,0 +1,766 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+
+#include "commandExecutor.hpp"
+#include "session.hpp"
+
+static std::atomic<std::size_t> allocationCount{0};
+
+// Every replaceable form is defined so each new is paired with a matching delete from this file.
+static void *countedAllocation(std::size_t size, std::align_val_t alignment = std::align_val_t{alignof(std::max_align_t)})
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    std::size_t align = std::max(static_cast<std::size_t>(alignment), alignof(std::max_align_t));
+    void *memory = nullptr;
+    if (::posix_memalign(&memory, align, size == 0 ? 1 : size) != 0)
+    {
+        return nullptr;
+    }
+    return memory;
+}
+
+static void *countedAllocationOrThrow(std::size_t size, std::align_val_t alignment = std::align_val_t{alignof(std::max_align_t)})
+{
+    if (void *memory = countedAllocation(size, alignment))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size) { return countedAllocationOrThrow(size); }
+void *operator new[](std::size_t size) { return countedAllocationOrThrow(size); }
+void *operator new(std::size_t size, std::align_val_t alignment) { return countedAllocationOrThrow(size, alignment); }
+void *operator new[](std::size_t size, std::align_val_t alignment) { return countedAllocationOrThrow(size, alignment); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return countedAllocation(size); }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { return countedAllocation(size); }
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept { return countedAllocation(size, alignment); }
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept { return countedAllocation(size, alignment); }
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete[](void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void *memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void *memory, const std::nothrow_t &) noexcept { std::free(memory); }
+void operator delete[](void *memory, const std::nothrow_t &) noexcept { std::free(memory); }
+void operator delete(void *memory, std::align_val_t, const std::nothrow_t &) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::align_val_t, const std::nothrow_t &) noexcept { std::free(memory); }
+
+static std::size_t allocationsSoFar()
+{
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+static void reportAllocations(benchmark::State &state, std::size_t allocationsBefore, std::int64_t operationsPerIteration = 1)
+{
+    state.counters["allocs/op"] = benchmark::Counter(static_cast<double>(allocationsSoFar() - allocationsBefore) / static_cast<double>(operationsPerIteration), benchmark::Counter::kAvgIterations);
+}
+
+static std::vector<std::string> makeNames(const std::string &prefix, int count)
+{
+    std::vector<std::string> names;
+    names.reserve(count);
+    for (int index = 0; index < count; ++index)
+    {
+        names.push_back(prefix + std::to_string(index));
+    }
+    return names;
+}
+
+static std::shared_ptr<Directory> buildTree(FileSystem &fileSystem, int nodeCount, const std::string &content = "")
+{
+    int width = 1;
+    while (width * width < nodeCount)
+    {
+        ++width;
+    }
+    std::shared_ptr<Directory> tree = fileSystem.makeDirectory("tree");
+    for (int directoryIndex = 0; directoryIndex < width; ++directoryIndex)
+    {
+        std::shared_ptr<Directory> directory = fileSystem.makeDirectory("dir" + std::to_string(directoryIndex));
+        for (int fileIndex = 0; fileIndex + 1 < width; ++fileIndex)
+        {
+            std::shared_ptr<File> file = fileSystem.makeFile("file" + std::to_string(fileIndex));
+            if (!content.empty())
+            {
+                file->setContent(content);
+            }
+            directory->addChild(file);
+        }
+        tree->addChild(directory);
+    }
+    return tree;
+}
+
+static void BM_FindChildByWidth(benchmark::State &state)
+{
+    Directory directory("wide");
+    std::vector<std::string> names = makeNames("entry", state.range(0));
+    for (auto &name : names)
+    {
+        directory.addChild(std::make_shared<File>(name));
+    }
+    std::size_t index = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(directory.findChild(names[index]));
+        index = (index + 1) % names.size();
+    }
+}
+BENCHMARK(BM_FindChildByWidth)->RangeMultiplier(8)->Range(8, 1 << 15);
+
+static void BM_ChangeDirectoryByWidth(benchmark::State &state)
+{
+    FileSystem fileSystem;
+    fileSystem.createDirectory("a/b/c");
+    for (auto &name : makeNames("sibling", state.range(0)))
+    {
+        fileSystem.createDirectory(name);
+        fileSystem.createDirectory("a/" + name);
+        fileSystem.createDirectory("a/b/" + name);
+    }
+    std::size_t allocationsBefore = allocationsSoFar();
+    for (auto _ : state)
+    {
+        fileSystem.changeDirectory("a/b/c");
+        fileSystem.changeDirectory(" ");
+    }
+    reportAllocations(state, allocationsBefore);
+}
+BENCHMARK(BM_ChangeDirectoryByWidth)->RangeMultiplier(8)->Range(8, 1 << 15);
+
+static void BM_MoveUpByDepth(benchmark::State &state)
+{
+    FileSystem fileSystem;
+    std::string deepPath = "d";
+    std::string upPath = "..";
+    for (int level = 1; level < state.range(0); ++level)
+    {
+        deepPath += "/d";
+        upPath += "/..";
+    }
+    fileSystem.createDirectory(deepPath);
+    std::size_t allocationsBefore = allocationsSoFar();
+    for (auto _ : state)
+    {
+        fileSystem.changeDirectory(deepPath);
+        fileSystem.changeDirectory(upPath);
+    }
+    reportAllocations(state, allocationsBefore);
+}
+BENCHMARK(BM_MoveUpByDepth)->RangeMultiplier(4)->Range(4, 256);
+
+static void BM_ResolvePath(benchmark::State &state)
+{
+    std::shared_ptr<Directory> root = std::make_shared<Directory>("root");
+    root->setContext(std::make_shared<TreeContext>());
+    Directory *current = root.get();
+    for (auto name : {"usr", "local", "share", "vfs", "data"})
+    {
+        std::shared_ptr<Directory> child = std::make_shared<Directory>(name);
+        current->addChild(child);
+        current = child.get();
+    }
+    current->addChild(std::make_shared<File>("hot.txt"));
+    PathResolver resolver(state.range(0));
+    std::string path = "~/usr/local/share/vfs/data/hot.txt";
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(resolver.resolve(path, root.get(), root.get()).component);
+    }
+}
+BENCHMARK(BM_ResolvePath)->Arg(0)->Arg(1024);
+
+static void BM_TreeWalkByName(benchmark::State &state)
+{
+    FileSystem fileSystem;
+    fileSystem.setWorkingDirectory(buildTree(fileSystem, state.range(0)));
+    std::size_t allocationsBefore = allocationsSoFar();
+    for (auto _ : state)
+    {
+        fileSystem.findFile("-file missing");
+    }
+    reportAllocations(state, allocationsBefore);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TreeWalkByName)->RangeMultiplier(32)->Range(1 << 10, 1 << 20)->Unit(benchmark::kMillisecond);
+
+static void BM_FindByNameIndexed(benchmark::State &state)
+{
+    FileSystem fileSystem;
+    fileSystem.getWorkingDirectory()->addChild(buildTree(fileSystem, state.range(0)));
+    std::stringstream discardedOutput;
+    std::streambuf *realOutput = std::cout.rdbuf(discardedOutput.rdbuf());
+    std::size_t allocationsBefore = allocationsSoFar();
+    for (auto _ : state)
+    {
+        fileSystem.findFile("-file file7");
+    }
+    reportAllocations(state, allocationsBefore);
+    std::cout.rdbuf(realOutput);
+}
+BENCHMARK(BM_FindByNameIndexed)->RangeMultiplier(32)->Range(1 << 10, 1 << 20)->Unit(benchmark::kMicrosecond);
+
+static void BM_FindRecentByTimeIndex(benchmark::State &state)
+{
+    FileSystem fileSystem;
+    fileSystem.getWorkingDirectory()->addChild(buildTree(fileSystem, state.range(0)));
+    std::stringstream discardedOutput;
+    std::streambuf *realOutput = std::cout.rdbuf(discardedOutput.rdbuf());
+    std::size_t allocationsBefore = allocationsSoFar();
+    for (auto _ : state)
+    {
+        fileSystem.findFile("-time 0");
+    }
+    reportAllocations(state, allocationsBefore);
+    std::cout.rdbuf(realOutput);
+}
+BENCHMARK(BM_FindRecentByTimeIndex)->RangeMultiplier(32)->Range(1 << 10, 1 << 20)->Unit(benchmark::kMicrosecond);
+
+static void BM_RemoveBySuffix(benchmark::State &state)
+{
+    std::vector<std::string> names = makeNames("file", state.range(0));
+    std::stringstream discardedOutput;
+    std::streambuf *realOutput = std::cout.rdbuf(discardedOutput.rdbuf());
+    std::unique_ptr<FileSystem> fileSystem;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        fileSystem = std::make_unique<FileSystem>();
+        for (std::size_t index = 0; index < names.size(); ++index)
+        {
+            fileSystem->getWorkingDirectory()->addChild(fileSystem->makeFile(names[index] + (index % 100 == 0 ? ".tmp" : ".dat")));
+        }
+        state.ResumeTiming();
+        fileSystem->removeFile("*.tmp");
+        state.PauseTiming();
+        fileSystem.reset();
+        state.ResumeTiming();
+    }
+    std::cout.rdbuf(realOutput);
+}
+BENCHMARK(BM_RemoveBySuffix)->RangeMultiplier(8)->Range(1 << 12, 200000)->Unit(benchmark::kMicrosecond);
+
+static void BM_GlobMatch(benchmark::State &state)
+{
+    GlobPattern pattern(state.range(0) == 0 ? "*.tmp" : "file[0-9]?*.t?p");
+    std::vector<std::string> names = makeNames("file", 1024);
+    for (auto _ : state)
+    {
+        int matches = 0;
+        for (auto &name : names)
+        {
+            matches += pattern.matches(name);
+        }
+        benchmark::DoNotOptimize(matches);
+    }
+}
+BENCHMARK(BM_GlobMatch)->ArgName("general")->Arg(0)->Arg(1);
+
+static void BM_ListDirectory(benchmark::State &state)
+{
+    FileSystem fileSystem;
+    for (auto &name : makeNames("entry", state.range(0)))
+    {
+        fileSystem.getWorkingDirectory()->addChild(fileSystem.makeFile(name));
+    }
+    std::stringstream discardedOutput;
+    std::streambuf *realOutput = std::cout.rdbuf(discardedOutput.rdbuf());
+    std::size_t allocationsBefore = allocationsSoFar();
+    for (auto _ : state)
+    {
+        fileSystem.displayFiles();
+        discardedOutput.str("");
+    }
+    reportAllocations(state, allocationsBefore);
+    std::cout.rdbuf(realOutput);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ListDirectory)->RangeMultiplier(32)->Range(1 << 10, 1 << 20)->Unit(benchmark::kMillisecond);
+
+static std::unique_ptr<FileSystem> sessionFileSystem;
+
+static void setUpSessionTree(const benchmark::State &state)
+{
+    if (state.thread_index() != 0)
+    {
+        return;
+    }
+    sessionFileSystem = std::make_unique<FileSystem>();
+    Session session(*sessionFileSystem);
+    for (int worker = 0; worker < 8; ++worker)
+    {
+        std::string directory = "d" + std::to_string(worker);
+        session.createDirectory(directory);
+        for (auto &name : makeNames("f", 256))
+        {
+            session.createFile(directory + "/" + name);
+            session.appendToFile(directory + "/" + name, "payload");
+        }
+    }
+    sessionFileSystem->setLockFreeReads(state.range(0) != 0);
+}
+
+static void tearDownSessionTree(const benchmark::State &state)
+{
+    if (state.thread_index() == 0)
+    {
+        sessionFileSystem.reset();
+    }
+}
+
+static void BM_SessionRead(benchmark::State &state)
+{
+    Session session(*sessionFileSystem);
+    std::string path = "d" + std::to_string(state.thread_index() % 8) + "/f17";
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(session.readFile(path));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SessionRead)->ArgName("lockFree")->Arg(0)->Arg(1)->Setup(setUpSessionTree)->Teardown(tearDownSessionTree)->Threads(1)->Threads(2)->Threads(4)->Threads(8)->UseRealTime();
+
+static void BM_SessionMixed(benchmark::State &state)
+{
+    Session session(*sessionFileSystem);
+    std::string directory = "d" + std::to_string(state.thread_index() % 8);
+    session.changeDirectory(directory);
+    ListingCursor firstPage;
+    firstPage.limit = 16;
+    std::size_t operation = 0;
+    for (auto _ : state)
+    {
+        std::string name = "f" + std::to_string(operation % 256);
+        if (operation % 8 == 0)
+        {
+            session.appendToFile(name, "x");
+        }
+        else if (operation % 8 == 1)
+        {
+            benchmark::DoNotOptimize(session.listDirectory("", firstPage));
+        }
+        else
+        {
+            benchmark::DoNotOptimize(session.readFile(name));
+        }
+        ++operation;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SessionMixed)->ArgName("lockFree")->Arg(0)->Arg(1)->Setup(setUpSessionTree)->Teardown(tearDownSessionTree)->Threads(1)->Threads(2)->Threads(4)->Threads(8)->UseRealTime();
+
+static std::string buildSnapshotFile(int fileCount, std::size_t fileSize)
+{
+    FileSystem fileSystem;
+    std::string payload(fileSize, 'x');
+    for (int directory = 0; directory < fileCount / 256 + 1; ++directory)
+    {
+        std::shared_ptr<Directory> parent = fileSystem.makeDirectory("d" + std::to_string(directory));
+        fileSystem.getRootDirectory()->addChild(parent);
+        for (auto &name : makeNames("f", std::min(256, fileCount - directory * 256)))
+        {
+            std::shared_ptr<File> file = fileSystem.makeFile(name);
+            file->setContent(payload);
+            parent->addChild(file);
+        }
+    }
+    std::string path = "/tmp/vfs_bench_snapshot.bin";
+    fileSystem.saveSnapshotTo(path);
+    return path;
+}
+
+static void BM_SnapshotLoad(benchmark::State &state)
+{
+    std::string path = buildSnapshotFile(static_cast<int>(state.range(0)), static_cast<std::size_t>(state.range(1)));
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        std::unique_ptr<FileSystem> fileSystem = std::make_unique<FileSystem>();
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(fileSystem->loadSnapshotFrom(path));
+        state.PauseTiming();
+        fileSystem.reset();
+        state.ResumeTiming();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * state.range(1));
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_SnapshotLoad)->ArgNames({"files", "fileSize"})->ArgsProduct({{1 << 10, 1 << 14}, {64, 64 << 10}})->Unit(benchmark::kMillisecond);
+
+static void BM_JournaledMutations(benchmark::State &state)
+{
+    std::string directory = "/tmp/vfs_bench_journal";
+    std::filesystem::remove_all(directory);
+    std::unique_ptr<FileSystem> fileSystem = std::make_unique<FileSystem>();
+    if (state.range(0) != 0)
+    {
+        JournalOptions options;
+        options.syncPolicy = static_cast<SyncPolicy>(state.range(0) - 1);
+        options.compactionThreshold = 0;
+        fileSystem->openJournal(directory, options);
+    }
+    std::size_t operation = 0;
+    for (auto _ : state)
+    {
+        std::string name = "f" + std::to_string(operation++);
+        fileSystem->createFileAt(name);
+        fileSystem->appendToFile(name, "payload");
+    }
+    fileSystem->syncJournal();
+    state.SetItemsProcessed(state.iterations() * 2);
+    fileSystem.reset();
+    std::filesystem::remove_all(directory);
+}
+BENCHMARK(BM_JournaledMutations)->ArgName("journal")->Arg(0)->Arg(1)->Arg(2)->Arg(3)->UseRealTime();
+
+static void BM_CommandScript(benchmark::State &state)
+{
+    std::string script;
+    for (int index = 0; index < 256; ++index)
+    {
+        std::string name = "f" + std::to_string(index);
+        script += "mkdir d" + std::to_string(index % 16) + "\ncd d" + std::to_string(index % 16) + "\ntouch " + name + "\necho " + name + "\npayload\nexit\ncat " + name + "\ncd ..\n";
+    }
+    script += "exit\n";
+    std::ostream discarded(nullptr);
+    std::streambuf *realcin = std::cin.rdbuf();
+    std::streambuf *realcout = std::cout.rdbuf(discarded.rdbuf());
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        std::shared_ptr<FileSystem> fileSystem = std::make_shared<FileSystem>();
+        fileSystem->setOutputSink(std::make_shared<BufferedStreamSink>(discarded));
+        std::unique_ptr<CommandExecutor> commandExecutor = std::make_unique<CommandExecutor>(fileSystem);
+        std::istringstream input(script);
+        state.ResumeTiming();
+        if (state.range(0) == 0)
+        {
+            std::cin.rdbuf(input.rdbuf());
+            commandExecutor->readCommandLine();
+        }
+        else
+        {
+            commandExecutor->runBatch(input, discarded);
+        }
+        state.PauseTiming();
+        commandExecutor.reset();
+        fileSystem.reset();
+        state.ResumeTiming();
+    }
+    std::cin.rdbuf(realcin);
+    std::cout.rdbuf(realcout);
+    state.SetItemsProcessed(state.iterations() * 256 * 6);
+}
+BENCHMARK(BM_CommandScript)->ArgName("batch")->Arg(0)->Arg(1);
+
+static void BM_CreateNodes(benchmark::State &state)
+{
+    bool files = state.range(0) != 0;
+    std::int64_t fanOut = state.range(1);
+    std::int64_t depth = state.range(2);
+    std::unique_ptr<FileSystem> fileSystem;
+    std::vector<std::string> paths;
+    std::size_t allocationsBefore = allocationsSoFar();
+    std::size_t allocationsDuringSetup = 0;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        std::size_t setupBefore = allocationsSoFar();
+        fileSystem = std::make_unique<FileSystem>();
+        std::string parent = "level0";
+        for (std::int64_t level = 1; level < depth; ++level)
+        {
+            parent += "/level" + std::to_string(level);
+        }
+        fileSystem->createDirectories(parent);
+        paths = makeNames(parent + "/node", static_cast<int>(fanOut));
+        allocationsDuringSetup += allocationsSoFar() - setupBefore;
+        state.ResumeTiming();
+        for (const std::string &path : paths)
+        {
+            if (files)
+            {
+                fileSystem->createFileAt(path);
+            }
+            else
+            {
+                fileSystem->createDirectories(path);
+            }
+        }
+        state.PauseTiming();
+        setupBefore = allocationsSoFar();
+        fileSystem.reset();
+        allocationsDuringSetup += allocationsSoFar() - setupBefore;
+        state.ResumeTiming();
+    }
+    state.counters["allocs/op"] = benchmark::Counter(static_cast<double>(allocationsSoFar() - allocationsBefore - allocationsDuringSetup) / static_cast<double>(fanOut), benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * fanOut);
+}
+BENCHMARK(BM_CreateNodes)->ArgNames({"file", "fanOut", "depth"})->ArgsProduct({{0, 1}, {16, 1024, 16384}, {1, 8, 64}})->Unit(benchmark::kMicrosecond);
+
+static void BM_ChangeDirectoryPath(benchmark::State &state)
+{
+    FileSystem fileSystem;
+    std::string deepPath = "d0";
+    std::string detourPath = "d0";
+    for (std::int64_t level = 1; level < state.range(0); ++level)
+    {
+        deepPath += "/d" + std::to_string(level);
+        detourPath += "/../d0";
+        for (std::int64_t back = 1; back <= level; ++back)
+        {
+            detourPath += "/d" + std::to_string(back);
+        }
+    }
+    fileSystem.createDirectories(deepPath);
+    const std::string &path = state.range(1) == 0 ? deepPath : detourPath;
+    std::size_t allocationsBefore = allocationsSoFar();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(fileSystem.enterDirectory(path).value);
+        fileSystem.enterDirectory("/");
+    }
+    reportAllocations(state, allocationsBefore);
+    state.SetLabel(std::to_string(path.size()) + " byte path");
+}
+BENCHMARK(BM_ChangeDirectoryPath)->ArgNames({"depth", "dotDot"})->ArgsProduct({{4, 32, 128}, {0, 1}});
+
+static void BM_WriteToFile(benchmark::State &state)
+{
+    FileSystem fileSystem;
+    std::ostream discarded(nullptr);
+    fileSystem.setOutputSink(std::make_shared<BufferedStreamSink>(discarded));
+    fileSystem.createFile("log");
+    std::istringstream input(std::string(state.range(0), 'x') + "\nexit\n");
+    std::streambuf *realcin = std::cin.rdbuf(input.rdbuf());
+    std::size_t allocationsBefore = allocationsSoFar();
+    for (auto _ : state)
+    {
+        input.clear();
+        input.seekg(0);
+        fileSystem.writeToFile("log");
+    }
+    reportAllocations(state, allocationsBefore);
+    std::cin.rdbuf(realcin);
+    state.SetBytesProcessed(state.iterations() * (state.range(0) + 1));
+}
+BENCHMARK(BM_WriteToFile)->Arg(64)->Arg(4096);
+
+static void findModesAndTreeSizes(benchmark::internal::Benchmark *benchmark)
+{
+    std::int64_t largest = std::getenv("VFS_BENCH_HUGE") != nullptr ? 10000000 : 1000000;
+    benchmark->ArgNames({"mode", "nodes"});
+    for (std::int64_t mode = 0; mode < 3; ++mode)
+    {
+        for (std::int64_t nodes = 1000; nodes <= largest; nodes *= 10)
+        {
+            benchmark->Args({mode, nodes});
+        }
+    }
+}
+
+static void BM_FindModes(benchmark::State &state)
+{
+    FindQuery query;
+    query.kind = static_cast<FindKind>(state.range(0));
+    query.pattern = query.kind == FindKind::Name ? "file7" : "timeout";
+    query.range = std::chrono::hours(1);
+    FileSystem fileSystem;
+    fileSystem.getWorkingDirectory()->addChild(buildTree(fileSystem, static_cast<int>(state.range(1)), "INFO request served in 12ms by worker-7\n"));
+    std::size_t allocationsBefore = allocationsSoFar();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(fileSystem.find(query).value.size());
+    }
+    reportAllocations(state, allocationsBefore);
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_FindModes)->Apply(findModesAndTreeSizes)->Unit(benchmark::kMicrosecond);
+
+// Caller-visible cost of removing a populated tree: the old per-node detach versus rmdir -r, whose teardown runs on the reclaimer thread.
+static void BM_RemoveTree(benchmark::State &state)
+{
+    std::unique_ptr<FileSystem> fileSystem;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        fileSystem = std::make_unique<FileSystem>();
+        fileSystem->getRootDirectory()->addChild(buildTree(*fileSystem, static_cast<int>(state.range(1))));
+        state.ResumeTiming();
+        if (state.range(0) == 0)
+        {
+            fileSystem->getRootDirectory()->removeChild("tree");
+        }
+        else
+        {
+            benchmark::DoNotOptimize(fileSystem->deleteDirectory("tree", true));
+        }
+        state.PauseTiming();
+        fileSystem.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_RemoveTree)->ArgNames({"background", "nodes"})->ArgsProduct({{0, 1}, {1000, 100000}})->Iterations(20)->Unit(benchmark::kMicrosecond);
+
+static void BM_NodeKindCheck(benchmark::State &state)
+{
+    std::vector<std::shared_ptr<FileSystemComponent>> nodes;
+    for (int index = 0; index < 1024; ++index)
+    {
+        nodes.push_back(index % 2 == 0 ? std::shared_ptr<FileSystemComponent>(std::make_shared<File>("f")) : std::make_shared<Directory>("d"));
+    }
+    for (auto _ : state)
+    {
+        int files = 0;
+        for (auto &node : nodes)
+        {
+            files += state.range(0) == 0 ? node->isFile() : node->getComponentType() == "File";
+        }
+        benchmark::DoNotOptimize(files);
+    }
+}
+BENCHMARK(BM_NodeKindCheck)->ArgName("componentTypeShim")->Arg(0)->Arg(1);
+
+static void BM_BuildAndTearDownTree(benchmark::State &state)
+{
+    const int width = 1024;
+    for (auto _ : state)
+    {
+        NodeArena arena;
+        std::pmr::memory_resource *resource = state.range(0) ? &arena : std::pmr::get_default_resource();
+        std::shared_ptr<Directory> root = state.range(0) ? std::allocate_shared<Directory>(ArenaAllocator<Directory>(&arena), "root", resource) : std::make_shared<Directory>("root");
+        for (int directoryIndex = 0; directoryIndex < width; ++directoryIndex)
+        {
+            std::string name = "d" + std::to_string(directoryIndex);
+            std::shared_ptr<Directory> directory = state.range(0) ? std::allocate_shared<Directory>(ArenaAllocator<Directory>(&arena), name, resource) : std::make_shared<Directory>(name);
+            root->addChild(directory);
+            for (int fileIndex = 0; fileIndex < width; ++fileIndex)
+            {
+                std::string fileName = "f" + std::to_string(fileIndex);
+                directory->addChild(state.range(0) ? std::allocate_shared<File>(ArenaAllocator<File>(&arena), fileName) : std::make_shared<File>(fileName));
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * width * width);
+}
+BENCHMARK(BM_BuildAndTearDownTree)->ArgName("arena")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+static void BM_AppendContent(benchmark::State &state)
+{
+    std::string line(state.range(0), 'x');
+    std::size_t allocationsBefore = allocationsSoFar();
+    for (auto _ : state)
+    {
+        File file("log");
+        for (int index = 0; index < 4096; ++index)
+        {
+            file.setContent(line);
+        }
+        benchmark::DoNotOptimize(file.getSize());
+    }
+    reportAllocations(state, allocationsBefore, 4096);
+    state.SetBytesProcessed(state.iterations() * 4096 * state.range(0));
+}
+BENCHMARK(BM_AppendContent)->Arg(64)->Arg(4096);
+
+static void BM_FindInContent(benchmark::State &state)
+{
+    File file("log");
+    std::string line = "INFO request served in 12ms by worker-7\n";
+    while (file.getSize() < static_cast<std::size_t>(state.range(0)))
+    {
+        file.setContent(line);
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(file.getFileContent().find("ERROR"));
+    }
+    state.SetBytesProcessed(state.iterations() * file.getSize());
+}
+BENCHMARK(BM_FindInContent)->Arg(1 << 20)->Arg(64 << 20);
+
+static void buildContentTree(FileSystem &fileSystem)
+{
+    fileSystem.createDirectory("search");
+    fileSystem.changeDirectory("search");
+    std::shared_ptr<Directory> searchRoot = fileSystem.getWorkingDirectory();
+    std::string line = "INFO request served in 12ms by worker-7\n";
+    for (int directoryIndex = 0; directoryIndex < 128; ++directoryIndex)
+    {
+        std::shared_ptr<Directory> directory = fileSystem.makeDirectory("dir" + std::to_string(directoryIndex));
+        searchRoot->addChild(directory);
+        for (int fileIndex = 0; fileIndex < 128; ++fileIndex)
+        {
+            std::shared_ptr<File> file = fileSystem.makeFile("file" + std::to_string(fileIndex));
+            for (int lineIndex = 0; lineIndex < 64; ++lineIndex)
+            {
+                file->setContent(line);
+            }
+            directory->addChild(file);
+        }
+    }
+}
+
+static void BM_FindContentThreads(benchmark::State &state)
+{
+    FileSystem fileSystem;
+    buildContentTree(fileSystem);
+    std::string arguments = "-j " + std::to_string(state.range(0)) + " -content needle";
+    std::stringstream discardedOutput;
+    std::streambuf *realOutput = std::cout.rdbuf(discardedOutput.rdbuf());
+    for (auto _ : state)
+    {
+        fileSystem.findFile(arguments);
+    }
+    std::cout.rdbuf(realOutput);
+}
+BENCHMARK(BM_FindContentThreads)->ArgName("threads")->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_SearchKernel(benchmark::State &state)
+{
+    std::string text;
+    while (text.size() < (16 << 20))
+    {
+        text += "INFO request served in 12ms by worker-7 from region eu-west\n";
+    }
+    SearchKernel kernel = static_cast<SearchKernel>(state.range(0));
+    bool ignoreCase = state.range(1) != 0;
+    state.SetLabel(searchKernelName(kernel));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(findSubstring(text, "timeout", ignoreCase, kernel));
+    }
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_SearchKernel)->ArgNames({"kernel", "ignoreCase"})->ArgsProduct({{0, 1, 2}, {0, 1}});
+
+static void BM_FindContentIndexed(benchmark::State &state)
+{
+    FileSystem fileSystem;
+    buildContentTree(fileSystem);
+    fileSystem.changeDirectory(" ");
+    fileSystem.setContentIndexEnabled(state.range(0) != 0);
+    std::stringstream discardedOutput;
+    std::streambuf *realOutput = std::cout.rdbuf(discardedOutput.rdbuf());
+    std::size_t allocationsBefore = allocationsSoFar();
+    for (auto _ : state)
+    {
+        fileSystem.findFile("-content timeout");
+    }
+    reportAllocations(state, allocationsBefore);
+    std::cout.rdbuf(realOutput);
+}
+BENCHMARK(BM_FindContentIndexed)->ArgName("indexed")->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
\ No newline at end of file
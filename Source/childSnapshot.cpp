@@ -0,0 +1,114 @@
+#include <algorithm>
+
+#include "childSnapshot.hpp"
+
+static bool entryBefore(const ChildSnapshot::Entry &entry, std::string_view name)
+{
+    return std::string_view(entry.first) < name;
+}
+
+ChildSnapshot::ChildSnapshot(const ChildTable &table) : entryCount(table.size())
+{
+    Block block;
+    for (const Entry &entry : table)
+    {
+        block.push_back(entry);
+        if (block.size() == blockCapacity)
+        {
+            blocks.push_back(std::make_shared<const Block>(std::move(block)));
+            block.clear();
+        }
+    }
+    if (!block.empty())
+    {
+        blocks.push_back(std::make_shared<const Block>(std::move(block)));
+    }
+}
+
+// Blocks unchanged since the previous snapshot are shared with it, but only the published snapshot is live for long.
+std::size_t ChildSnapshot::allocatedBytes() const
+{
+    std::size_t bytes = sizeof(ChildSnapshot) + blocks.capacity() * sizeof(std::shared_ptr<const Block>);
+    for (auto &block : blocks)
+    {
+        bytes += sizeof(Block) + block->capacity() * sizeof(Entry);
+    }
+    return bytes;
+}
+
+std::size_t ChildSnapshot::blockFor(std::string_view name) const
+{
+    auto following = std::upper_bound(blocks.begin(), blocks.end(), name, [](std::string_view key, const std::shared_ptr<const Block> &block)
+                                      { return key < std::string_view(block->front().first); });
+    return following == blocks.begin() ? 0 : static_cast<std::size_t>(following - blocks.begin()) - 1;
+}
+
+const ChildSnapshot::Entry *ChildSnapshot::find(std::string_view name) const
+{
+    if (blocks.empty())
+    {
+        return nullptr;
+    }
+    const Block &entries = *blocks[blockFor(name)];
+    auto found = std::lower_bound(entries.begin(), entries.end(), name, entryBefore);
+    return found != entries.end() && found->first == name ? &*found : nullptr;
+}
+
+std::unique_ptr<ChildSnapshot> ChildSnapshot::withChild(std::string_view name, const std::shared_ptr<FileSystemComponent> &child) const
+{
+    std::unique_ptr<ChildSnapshot> next = std::make_unique<ChildSnapshot>(*this);
+    if (blocks.empty())
+    {
+        next->blocks.push_back(std::make_shared<const Block>(Block{Entry(std::string(name), child)}));
+        next->entryCount = 1;
+        return next;
+    }
+    std::size_t blockIndex = blockFor(name);
+    Block entries = *blocks[blockIndex];
+    auto found = std::lower_bound(entries.begin(), entries.end(), name, entryBefore);
+    if (found != entries.end() && found->first == name)
+    {
+        found->second = child;
+    }
+    else
+    {
+        entries.emplace(found, std::string(name), child);
+        ++next->entryCount;
+    }
+    if (entries.size() > blockCapacity)
+    {
+        Block upperHalf(std::make_move_iterator(entries.begin() + blockCapacity / 2), std::make_move_iterator(entries.end()));
+        entries.resize(blockCapacity / 2);
+        next->blocks.insert(next->blocks.begin() + blockIndex + 1, std::make_shared<const Block>(std::move(upperHalf)));
+    }
+    next->blocks[blockIndex] = std::make_shared<const Block>(std::move(entries));
+    return next;
+}
+
+std::unique_ptr<ChildSnapshot> ChildSnapshot::withoutChild(std::string_view name) const
+{
+    std::unique_ptr<ChildSnapshot> next = std::make_unique<ChildSnapshot>(*this);
+    if (blocks.empty())
+    {
+        return next;
+    }
+    std::size_t blockIndex = blockFor(name);
+    const Block &entries = *blocks[blockIndex];
+    auto found = std::lower_bound(entries.begin(), entries.end(), name, entryBefore);
+    if (found == entries.end() || found->first != name)
+    {
+        return next;
+    }
+    --next->entryCount;
+    if (entries.size() == 1)
+    {
+        next->blocks.erase(next->blocks.begin() + blockIndex);
+        return next;
+    }
+    Block remaining;
+    remaining.reserve(entries.size() - 1);
+    remaining.insert(remaining.end(), entries.begin(), found);
+    remaining.insert(remaining.end(), found + 1, entries.end());
+    next->blocks[blockIndex] = std::make_shared<const Block>(std::move(remaining));
+    return next;
+}
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include <algorithm>
+
+#include "childTable.hpp"
+
+static bool entryBefore(const ChildTable::Entry &entry, std::string_view name)
+{
+    return std::string_view(entry.first) < name;
+}
+
+static bool nameBefore(std::string_view name, const ChildTable::Entry &entry)
+{
+    return name < std::string_view(entry.first);
+}
+
+std::size_t ChildTable::blockFor(std::string_view name) const
+{
+    if (blocks.size() == 1)
+    {
+        return 0;
+    }
+    auto following = std::upper_bound(blocks.begin(), blocks.end(), name, [](std::string_view key, const Block &block)
+                                      { return key < std::string_view(block.front().first); });
+    return following == blocks.begin() ? 0 : static_cast<std::size_t>(following - blocks.begin()) - 1;
+}
+
+ChildTable::const_iterator ChildTable::lowerBoundIn(std::size_t block, std::string_view name) const
+{
+    const Block &entries = blocks[block];
+    std::size_t position = std::lower_bound(entries.begin(), entries.end(), name, entryBefore) - entries.begin();
+    if (position == entries.size())
+    {
+        return const_iterator(this, block + 1, 0);
+    }
+    return const_iterator(this, block, position);
+}
+
+const ChildTable::Entry *ChildTable::find(std::string_view name) const
+{
+    if (blocks.empty())
+    {
+        return nullptr;
+    }
+    const Block &entries = blocks[blockFor(name)];
+    auto found = std::lower_bound(entries.begin(), entries.end(), name, entryBefore);
+    return found != entries.end() && found->first == name ? &*found : nullptr;
+}
+
+std::shared_ptr<FileSystemComponent> &ChildTable::findOrInsert(const NodeName &name)
+{
+    if (blocks.empty())
+    {
+        blocks.emplace_back();
+        blocks.back().reserve(8);
+    }
+    std::size_t blockIndex = blockFor(name);
+    Block *entries = &blocks[blockIndex];
+    auto found = std::lower_bound(entries->begin(), entries->end(), name.view(), entryBefore);
+    if (found != entries->end() && found->first == name)
+    {
+        return found->second;
+    }
+    std::size_t position = found - entries->begin();
+    if (entries->size() == blockCapacity)
+    {
+        Block upperHalf(std::make_move_iterator(entries->begin() + blockCapacity / 2), std::make_move_iterator(entries->end()), blocks.get_allocator());
+        entries->resize(blockCapacity / 2);
+        blocks.insert(blocks.begin() + blockIndex + 1, std::move(upperHalf));
+        if (position > blockCapacity / 2)
+        {
+            ++blockIndex;
+            position -= blockCapacity / 2;
+        }
+        entries = &blocks[blockIndex];
+    }
+    ++entryCount;
+    return entries->emplace(entries->begin() + position, name, nullptr)->second;
+}
+
+bool ChildTable::erase(std::string_view name)
+{
+    if (blocks.empty())
+    {
+        return false;
+    }
+    std::size_t blockIndex = blockFor(name);
+    Block &entries = blocks[blockIndex];
+    auto found = std::lower_bound(entries.begin(), entries.end(), name, entryBefore);
+    if (found == entries.end() || found->first != name)
+    {
+        return false;
+    }
+    entries.erase(found);
+    --entryCount;
+    if (entries.empty())
+    {
+        blocks.erase(blocks.begin() + blockIndex);
+    }
+    else if (entries.size() < blockCapacity / 4 && blockIndex + 1 < blocks.size() && entries.size() + blocks[blockIndex + 1].size() <= blockCapacity / 2)
+    {
+        Block &next = blocks[blockIndex + 1];
+        entries.insert(entries.end(), std::make_move_iterator(next.begin()), std::make_move_iterator(next.end()));
+        blocks.erase(blocks.begin() + blockIndex + 1);
+    }
+    return true;
+}
+
+std::size_t ChildTable::allocatedBytes() const
+{
+    std::size_t bytes = blocks.capacity() * sizeof(Block);
+    for (auto &block : blocks)
+    {
+        bytes += block.capacity() * sizeof(Entry);
+    }
+    return bytes;
+}
+
+void ChildTable::clear()
+{
+    blocks.clear();
+    entryCount = 0;
+}
+
+ChildTable::const_iterator ChildTable::lowerBound(std::string_view name) const
+{
+    return blocks.empty() ? end() : lowerBoundIn(blockFor(name), name);
+}
+
+ChildTable::const_iterator ChildTable::upperBound(std::string_view name) const
+{
+    if (blocks.empty())
+    {
+        return end();
+    }
+    std::size_t block = blockFor(name);
+    const Block &entries = blocks[block];
+    std::size_t position = std::upper_bound(entries.begin(), entries.end(), name, nameBefore) - entries.begin();
+    return position == entries.size() ? const_iterator(this, block + 1, 0) : const_iterator(this, block, position);
+}
+
+ChildTable::const_iterator ChildTable::atOffset(std::size_t offset) const
+{
+    if (offset >= entryCount)
+    {
+        return end();
+    }
+    std::size_t block = 0;
+    while (offset >= blocks[block].size())
+    {
+        offset -= blocks[block].size();
+        ++block;
+    }
+    return const_iterator(this, block, offset);
+}
+
+std::pair<ChildTable::const_iterator, ChildTable::const_iterator> ChildTable::prefixRange(std::string_view prefix) const
+{
+    const_iterator first = lowerBound(prefix);
+    const_iterator last = first;
+    while (last != end() && std::string_view(last->first).starts_with(prefix))
+    {
+        ++last;
+    }
+    return {first, last};
+}
\ No newline at end of file
@@ -1,3 +1,6 @@
+#include <iomanip>
+#include <iterator>
+
 #include "commandExecutor.hpp"
 
 void CommandExecutor::handlecd()
@@ -27,7 +30,14 @@ void CommandExecutor::handleecho()
 
 void CommandExecutor::handlels()
 {
-    fileSystemObject->displayFiles();
+    if (arguments.find_first_not_of(' ') == std::string::npos)
+    {
+        fileSystemObject->displayFiles();
+    }
+    else
+    {
+        fileSystemObject->listFiles(arguments);
+    }
 }
 
 void CommandExecutor::handlermdir()
@@ -45,6 +55,26 @@ void CommandExecutor::handlefindFile()
     fileSystemObject->findFile(arguments);
 }
 
+void CommandExecutor::handlesave()
+{
+    fileSystemObject->saveSnapshot(arguments);
+}
+
+void CommandExecutor::handleload()
+{
+    fileSystemObject->loadSnapshot(arguments);
+}
+
+void CommandExecutor::handlestats()
+{
+    fileSystemObject->displayStats(arguments);
+}
+
+void CommandExecutor::handledu()
+{
+    fileSystemObject->displayMemoryUsage(arguments);
+}
+
 bool CommandExecutor::isCommandName(const std::string &commandName)
 {
     auto foundCommand = commandMap.find(commandName);
@@ -94,4 +124,139 @@ void CommandExecutor::readCommandLine()
         }
         std::cout << fileSystemObject->getPathOfWorkingDirectory() << "$ ";
     }
+}
+
+void CommandExecutor::executeInstruction(const CommandScript &script, const ScriptInstruction &instruction)
+{
+    arguments.assign(script.argument(instruction));
+    switch (instruction.opcode)
+    {
+    case Opcode::ChangeDirectory:
+        fileSystemObject->changeDirectory(arguments);
+        break;
+    case Opcode::MakeDirectory:
+        fileSystemObject->createDirectory(arguments);
+        break;
+    case Opcode::Cat:
+        fileSystemObject->displayFileContent(arguments);
+        break;
+    case Opcode::Touch:
+        fileSystemObject->createFile(arguments);
+        break;
+    case Opcode::Echo:
+    {
+        FsResult<File *> appended = fileSystemObject->appendToFile(arguments, std::string(script.text(instruction)));
+        if (appended.status == FsStatus::PathNotFound || appended.status == FsStatus::NotADirectory)
+        {
+            fileSystemObject->getOutputSink() << "Directory not found:" << appended.detail << '\n';
+        }
+        else if (!appended.ok())
+        {
+            fileSystemObject->getOutputSink() << "File not found" << '\n';
+        }
+        break;
+    }
+    case Opcode::List:
+        handlels();
+        break;
+    case Opcode::RemoveDirectory:
+        fileSystemObject->removeDirectory(arguments);
+        break;
+    case Opcode::Remove:
+        fileSystemObject->removeFile(arguments);
+        break;
+    case Opcode::Find:
+        fileSystemObject->findFile(arguments);
+        break;
+    case Opcode::Save:
+        fileSystemObject->saveSnapshot(arguments);
+        break;
+    case Opcode::Load:
+        fileSystemObject->loadSnapshot(arguments);
+        break;
+    case Opcode::Stats:
+        fileSystemObject->displayStats(arguments);
+        break;
+    case Opcode::DiskUsage:
+        fileSystemObject->displayMemoryUsage(arguments);
+        break;
+    case Opcode::Help:
+        for (auto &command : commandMap)
+        {
+            fileSystemObject->getOutputSink() << command.first << '\n';
+        }
+        break;
+    case Opcode::Unknown:
+        fileSystemObject->getOutputSink() << "Command not found" << '\n';
+        break;
+    }
+}
+
+std::vector<CommandLatency> CommandExecutor::executeScript(const CommandScript &script)
+{
+    std::vector<std::vector<std::chrono::nanoseconds>> samples(CommandScript::opcodeCount);
+    std::shared_ptr<OutputSink> interactiveSink = fileSystemObject->replaceOutputSink(nullptr);
+    auto deferredSink = std::make_shared<DeferredFlushSink>(interactiveSink);
+    fileSystemObject->setOutputSink(deferredSink);
+    for (const ScriptInstruction &instruction : script.getInstructions())
+    {
+        auto started = std::chrono::steady_clock::now();
+        executeInstruction(script, instruction);
+        samples[static_cast<std::size_t>(instruction.opcode)].push_back(std::chrono::steady_clock::now() - started);
+    }
+    deferredSink->drain();
+    fileSystemObject->setOutputSink(interactiveSink);
+
+    std::vector<CommandLatency> latencies;
+    for (std::size_t index = 0; index < samples.size(); ++index)
+    {
+        std::vector<std::chrono::nanoseconds> &durations = samples[index];
+        if (durations.empty())
+        {
+            continue;
+        }
+        CommandLatency latency;
+        latency.command = CommandScript::commandName(static_cast<Opcode>(index));
+        latency.count = durations.size();
+        for (std::chrono::nanoseconds duration : durations)
+        {
+            latency.total += duration;
+        }
+        auto percentile = [&durations](std::size_t percent)
+        {
+            auto position = durations.begin() + static_cast<std::ptrdiff_t>((durations.size() - 1) * percent / 100);
+            std::nth_element(durations.begin(), position, durations.end());
+            return *position;
+        };
+        latency.median = percentile(50);
+        latency.p99 = percentile(99);
+        latency.maximum = *std::max_element(durations.begin(), durations.end());
+        latencies.push_back(std::move(latency));
+    }
+    return latencies;
+}
+
+void CommandExecutor::runBatch(std::istream &input, std::ostream &summary)
+{
+    std::string script(std::istreambuf_iterator<char>(input), {});
+    FsResult<CommandScript> parsed = CommandScript::parse(script);
+    if (!parsed.ok())
+    {
+        summary << "Cannot run script: " << parsed.detail << " (" << describeStatus(parsed.status) << ")" << std::endl;
+        return;
+    }
+    std::vector<CommandLatency> latencies = executeScript(parsed.value);
+    summary << std::left << std::setw(8) << "command" << std::right << std::setw(10) << "count" << std::setw(14) << "total us"
+            << std::setw(12) << "mean us" << std::setw(12) << "p50 us" << std::setw(12) << "p99 us" << std::setw(12) << "max us" << '\n';
+    summary << std::fixed << std::setprecision(2);
+    for (const CommandLatency &latency : latencies)
+    {
+        auto microseconds = [](std::chrono::nanoseconds duration)
+        { return std::chrono::duration<double, std::micro>(duration).count(); };
+        summary << std::left << std::setw(8) << latency.command << std::right << std::setw(10) << latency.count
+                << std::setw(14) << microseconds(latency.total) << std::setw(12) << microseconds(latency.total) / static_cast<double>(latency.count)
+                << std::setw(12) << microseconds(latency.median) << std::setw(12) << microseconds(latency.p99)
+                << std::setw(12) << microseconds(latency.maximum) << '\n';
+    }
+    summary.flush();
 }
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include "commandScript.hpp"
+
+static constexpr std::string_view commandNames[] = {"cd", "mkdir", "cat", "touch", "echo", "ls", "rmdir", "rm", "find", "save", "load", "stats", "du", "help", ""};
+
+static std::string_view trimmed(std::string_view line)
+{
+    std::size_t first = line.find_first_not_of(" \t\r");
+    if (first == std::string_view::npos)
+    {
+        return {};
+    }
+    return line.substr(first, line.find_last_not_of(" \t\r") - first + 1);
+}
+
+static bool nextLine(std::string_view &script, std::string_view &line)
+{
+    if (script.empty())
+    {
+        return false;
+    }
+    std::size_t lineEnd = script.find('\n');
+    line = script.substr(0, lineEnd);
+    script.remove_prefix(lineEnd == std::string_view::npos ? script.size() : lineEnd + 1);
+    return true;
+}
+
+Opcode CommandScript::opcodeFor(std::string_view command)
+{
+    for (std::size_t index = 0; index + 1 < opcodeCount; ++index)
+    {
+        if (commandNames[index] == command)
+        {
+            return static_cast<Opcode>(index);
+        }
+    }
+    return Opcode::Unknown;
+}
+
+const char *CommandScript::commandName(Opcode opcode)
+{
+    return opcode == Opcode::Unknown ? "unknown" : commandNames[static_cast<std::size_t>(opcode)].data();
+}
+
+std::uint32_t CommandScript::store(std::string_view text)
+{
+    std::uint32_t offset = static_cast<std::uint32_t>(pool.size());
+    pool.append(text);
+    return offset;
+}
+
+FsResult<CommandScript> CommandScript::parse(std::string_view script)
+{
+    CommandScript parsed;
+    std::string_view line;
+    while (nextLine(script, line))
+    {
+        line = trimmed(line);
+        if (line.empty() || line.front() == '#')
+        {
+            continue;
+        }
+        std::size_t commandEnd = line.find_first_of(" \t");
+        std::string_view command = line.substr(0, commandEnd);
+        if (command == "exit")
+        {
+            break;
+        }
+        std::string_view argument = commandEnd == std::string_view::npos ? std::string_view(" ") : trimmed(line.substr(commandEnd));
+        ScriptInstruction instruction{opcodeFor(command), 0, 0, 0, 0};
+        instruction.argumentOffset = parsed.store(instruction.opcode == Opcode::Unknown ? command : argument);
+        instruction.argumentLength = static_cast<std::uint32_t>(parsed.pool.size() - instruction.argumentOffset);
+        if (instruction.opcode == Opcode::Echo)
+        {
+            instruction.textOffset = static_cast<std::uint32_t>(parsed.pool.size());
+            std::string_view textLine;
+            while (nextLine(script, textLine))
+            {
+                if (!textLine.empty() && textLine.back() == '\r')
+                {
+                    textLine.remove_suffix(1);
+                }
+                if (textLine == "exit")
+                {
+                    break;
+                }
+                parsed.pool.append(textLine);
+                parsed.pool += '\n';
+            }
+            instruction.textLength = static_cast<std::uint32_t>(parsed.pool.size() - instruction.textOffset);
+        }
+        // Instructions address the pool with 32-bit offsets, so a larger script cannot be represented.
+        if (parsed.pool.size() > poolLimit)
+        {
+            return FsResult<CommandScript>::failure(FsStatus::InvalidArgument, "script exceeds " + std::to_string(poolLimit) + " bytes");
+        }
+        parsed.instructions.push_back(instruction);
+    }
+    return FsResult<CommandScript>::success(std::move(parsed));
+}
\ No newline at end of file
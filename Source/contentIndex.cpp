@@ -0,0 +1,136 @@
+#include <algorithm>
+
+#include "contentIndex.hpp"
+#include "directory.hpp"
+#include "file.hpp"
+
+static inline std::uint32_t foldTrigramByte(char character)
+{
+    unsigned char byte = static_cast<unsigned char>(character);
+    return (byte >= 'A' && byte <= 'Z') ? byte + ('a' - 'A') : byte;
+}
+
+void ContentIndex::collectTrigrams(std::string_view text, std::vector<std::uint32_t> &trigrams)
+{
+    for (std::size_t position = 0; position + gramLength <= text.size(); ++position)
+    {
+        trigrams.push_back(foldTrigramByte(text[position]) << 16 | foldTrigramByte(text[position + 1]) << 8 | foldTrigramByte(text[position + 2]));
+    }
+}
+
+void ContentIndex::collectFileTrigrams(const File &file, std::vector<std::uint32_t> &trigrams)
+{
+    std::string carry;
+    file.getFileContent().forEachChunk([&carry, &trigrams](std::string_view chunk)
+                                       {
+        if (!carry.empty())
+        {
+            carry.append(chunk.substr(0, gramLength - 1));
+            collectTrigrams(carry, trigrams);
+        }
+        collectTrigrams(chunk, trigrams);
+        carry.assign(chunk.substr(chunk.size() > gramLength - 1 ? chunk.size() - (gramLength - 1) : 0)); });
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+}
+
+void ContentIndex::addContent(File *file, std::string_view previousTail, std::string_view appendedText)
+{
+    std::vector<std::uint32_t> trigrams;
+    if (!previousTail.empty())
+    {
+        std::string boundary(previousTail);
+        boundary.append(appendedText.substr(0, gramLength - 1));
+        collectTrigrams(boundary, trigrams);
+    }
+    collectTrigrams(appendedText, trigrams);
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    for (auto trigram : trigrams)
+    {
+        postings[trigram].insert(file);
+    }
+}
+
+void ContentIndex::addSubtree(FileSystemComponent *component)
+{
+    if (File *file = asFile(component))
+    {
+        std::vector<std::uint32_t> trigrams;
+        collectFileTrigrams(*file, trigrams);
+        for (auto trigram : trigrams)
+        {
+            postings[trigram].insert(file);
+        }
+    }
+    else if (Directory *directory = asDirectory(component))
+    {
+        for (auto &child : directory->getChildren())
+        {
+            addSubtree(child.second.get());
+        }
+    }
+}
+
+void ContentIndex::removeSubtree(FileSystemComponent *component)
+{
+    if (File *file = asFile(component))
+    {
+        std::vector<std::uint32_t> trigrams;
+        collectFileTrigrams(*file, trigrams);
+        for (auto trigram : trigrams)
+        {
+            auto posting = postings.find(trigram);
+            if (posting != postings.end())
+            {
+                posting->second.erase(file);
+                if (posting->second.empty())
+                {
+                    postings.erase(posting);
+                }
+            }
+        }
+    }
+    else if (Directory *directory = asDirectory(component))
+    {
+        for (auto &child : directory->getChildren())
+        {
+            removeSubtree(child.second.get());
+        }
+    }
+}
+
+std::vector<File *> ContentIndex::findCandidates(std::string_view needle) const
+{
+    std::vector<std::uint32_t> trigrams;
+    collectTrigrams(needle, trigrams);
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    std::vector<const std::unordered_set<File *> *> postingLists;
+    for (auto trigram : trigrams)
+    {
+        auto posting = postings.find(trigram);
+        if (posting == postings.end())
+        {
+            return {};
+        }
+        postingLists.push_back(&posting->second);
+    }
+    if (postingLists.empty())
+    {
+        return {};
+    }
+    std::sort(postingLists.begin(), postingLists.end(), [](auto *left, auto *right)
+              { return left->size() < right->size(); });
+    std::vector<File *> candidates;
+    for (File *file : *postingLists.front())
+    {
+        bool inEveryList = std::all_of(postingLists.begin() + 1, postingLists.end(), [file](auto *postingList)
+                                       { return postingList->count(file) != 0; });
+        if (inEveryList)
+        {
+            candidates.push_back(file);
+        }
+    }
+    return candidates;
+}
\ No newline at end of file
@@ -0,0 +1,213 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define VFS_X86_SEARCH 1
+#endif
+
+#include "contentSearch.hpp"
+
+static inline unsigned char foldCase(unsigned char character)
+{
+    return (character >= 'A' && character <= 'Z') ? character + ('a' - 'A') : character;
+}
+
+static bool equalFolded(const char *text, const char *foldedNeedle, std::size_t length)
+{
+    for (std::size_t index = 0; index < length; ++index)
+    {
+        if (foldCase(text[index]) != static_cast<unsigned char>(foldedNeedle[index]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static std::size_t findScalar(std::string_view text, std::string_view needle, bool ignoreCase)
+{
+    if (!ignoreCase)
+    {
+        return text.find(needle);
+    }
+    for (std::size_t position = 0; position + needle.size() <= text.size(); ++position)
+    {
+        if (equalFolded(text.data() + position, needle.data(), needle.size()))
+        {
+            return position;
+        }
+    }
+    return std::string_view::npos;
+}
+
+#ifdef VFS_X86_SEARCH
+__attribute__((target("sse2"))) static inline __m128i foldBlock(__m128i block)
+{
+    __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(block, _mm_set1_epi8('Z' + 1)));
+    return _mm_add_epi8(block, _mm_and_si128(upper, _mm_set1_epi8('a' - 'A')));
+}
+
+__attribute__((target("sse2"))) static std::size_t findSse2(std::string_view text, std::string_view needle, bool ignoreCase)
+{
+    const std::size_t needleLength = needle.size();
+    const __m128i first = _mm_set1_epi8(needle.front());
+    const __m128i last = _mm_set1_epi8(needle.back());
+    std::size_t position = 0;
+    for (; position + needleLength - 1 + 16 <= text.size(); position += 16)
+    {
+        __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text.data() + position));
+        __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text.data() + position + needleLength - 1));
+        if (ignoreCase)
+        {
+            blockFirst = foldBlock(blockFirst);
+            blockLast = foldBlock(blockLast);
+        }
+        unsigned mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, blockFirst), _mm_cmpeq_epi8(last, blockLast)));
+        while (mask != 0)
+        {
+            unsigned offset = __builtin_ctz(mask);
+            const char *candidate = text.data() + position + offset;
+            if (ignoreCase ? equalFolded(candidate + 1, needle.data() + 1, needleLength - 2) : std::memcmp(candidate + 1, needle.data() + 1, needleLength - 2) == 0)
+            {
+                return position + offset;
+            }
+            mask &= mask - 1;
+        }
+    }
+    std::size_t found = findScalar(text.substr(position), needle, ignoreCase);
+    return found == std::string_view::npos ? found : position + found;
+}
+
+__attribute__((target("avx2"))) static inline __m256i foldBlock(__m256i block)
+{
+    __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(block, _mm256_set1_epi8('A' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), block));
+    return _mm256_add_epi8(block, _mm256_and_si256(upper, _mm256_set1_epi8('a' - 'A')));
+}
+
+__attribute__((target("avx2"))) static std::size_t findAvx2(std::string_view text, std::string_view needle, bool ignoreCase)
+{
+    const std::size_t needleLength = needle.size();
+    const __m256i first = _mm256_set1_epi8(needle.front());
+    const __m256i last = _mm256_set1_epi8(needle.back());
+    std::size_t position = 0;
+    for (; position + needleLength - 1 + 32 <= text.size(); position += 32)
+    {
+        __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(text.data() + position));
+        __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(text.data() + position + needleLength - 1));
+        if (ignoreCase)
+        {
+            blockFirst = foldBlock(blockFirst);
+            blockLast = foldBlock(blockLast);
+        }
+        std::uint32_t mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, blockFirst), _mm256_cmpeq_epi8(last, blockLast)));
+        while (mask != 0)
+        {
+            unsigned offset = __builtin_ctz(mask);
+            const char *candidate = text.data() + position + offset;
+            if (ignoreCase ? equalFolded(candidate + 1, needle.data() + 1, needleLength - 2) : std::memcmp(candidate + 1, needle.data() + 1, needleLength - 2) == 0)
+            {
+                return position + offset;
+            }
+            mask &= mask - 1;
+        }
+    }
+    std::size_t found = findSse2(text.substr(position), needle, ignoreCase);
+    return found == std::string_view::npos ? found : position + found;
+}
+#endif
+
+SearchKernel bestSearchKernel()
+{
+#ifdef VFS_X86_SEARCH
+    static const SearchKernel kernel = __builtin_cpu_supports("avx2") ? SearchKernel::Avx2 : (__builtin_cpu_supports("sse2") ? SearchKernel::Sse2 : SearchKernel::Scalar);
+    return kernel;
+#else
+    return SearchKernel::Scalar;
+#endif
+}
+
+const char *searchKernelName(SearchKernel kernel)
+{
+    switch (kernel)
+    {
+    case SearchKernel::Avx2:
+        return "avx2";
+    case SearchKernel::Sse2:
+        return "sse2";
+    default:
+        return "scalar";
+    }
+}
+
+std::size_t findSubstring(std::string_view text, std::string_view needle, bool ignoreCase)
+{
+    return findSubstring(text, needle, ignoreCase, bestSearchKernel());
+}
+
+std::size_t findSubstring(std::string_view text, std::string_view needle, bool ignoreCase, SearchKernel kernel)
+{
+    std::string foldedNeedle;
+    if (ignoreCase)
+    {
+        foldedNeedle.resize(needle.size());
+        std::transform(needle.begin(), needle.end(), foldedNeedle.begin(), foldCase);
+        needle = foldedNeedle;
+    }
+    if (needle.empty())
+    {
+        return 0;
+    }
+    if (needle.size() > text.size())
+    {
+        return std::string_view::npos;
+    }
+    if (needle.size() == 1 && !ignoreCase)
+    {
+        const void *found = std::memchr(text.data(), needle.front(), text.size());
+        return found == nullptr ? std::string_view::npos : static_cast<const char *>(found) - text.data();
+    }
+#ifdef VFS_X86_SEARCH
+    if (needle.size() >= 2 && bestSearchKernel() >= kernel)
+    {
+        if (kernel == SearchKernel::Avx2)
+        {
+            return findAvx2(text, needle, ignoreCase);
+        }
+        if (kernel == SearchKernel::Sse2)
+        {
+            return findSse2(text, needle, ignoreCase);
+        }
+    }
+#endif
+    return findScalar(text, needle, ignoreCase);
+}
+
+ContentMatcher::ContentMatcher(std::vector<std::string> patternsToFind, bool caseInsensitive) : patterns(std::move(patternsToFind)), ignoreCase(caseInsensitive)
+{
+}
+
+bool ContentMatcher::matches(std::string_view text) const
+{
+    for (auto &pattern : patterns)
+    {
+        if (findSubstring(text, pattern, ignoreCase) != std::string_view::npos)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ContentMatcher::matches(const FileContent &content) const
+{
+    for (auto &pattern : patterns)
+    {
+        if (content.find(pattern, ignoreCase) != FileContent::npos)
+        {
+            return true;
+        }
+    }
+    return false;
+}
\ No newline at end of file
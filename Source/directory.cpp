@@ -1,19 +1,310 @@
 #include "directory.hpp"
+#include "epochDomain.hpp"
+
+Directory::~Directory()
+{
+    delete publishedChildren.load();
+    for (auto &child : children)
+    {
+        if (child.second->getParent() == this)
+        {
+            child.second->setParent(nullptr);
+        }
+    }
+}
 
 void Directory::addChild(const std::shared_ptr<FileSystemComponent> &child)
 {
-    children[child->getName()] = child;
+    std::string_view childName = child->getNameView();
+    std::shared_ptr<FileSystemComponent> &slot = children.findOrInsert(child->getNodeName());
+    if (slot == child)
+    {
+        return;
+    }
+    if (slot != nullptr)
+    {
+        detachChild(slot);
+    }
+    slot = child;
+    child->setParent(this);
+    std::string_view extension = extensionOf(childName);
+    if (!extension.empty())
+    {
+        childrenByExtension[std::string(extension)].insert(child.get());
+    }
+    Directory *childDirectory = asDirectory(child.get());
+    if (childDirectory != nullptr && childDirectory->treeContext != treeContext)
+    {
+        childDirectory->setContext(treeContext);
+    }
+    if (const ChildSnapshot *snapshot = publishedChildren.load())
+    {
+        publishChildren(snapshot->withChild(childName, child));
+        if (childDirectory != nullptr && !childDirectory->hasLockFreeReads())
+        {
+            childDirectory->setLockFreeReads(true);
+        }
+    }
+    if (treeContext != nullptr)
+    {
+        std::unique_lock<std::shared_mutex> indexLock(treeContext->indexMutex);
+        ++treeContext->generation;
+        treeContext->nameIndex.addSubtree(child.get());
+        treeContext->timeIndex.addSubtree(child.get());
+        if (treeContext->contentIndex != nullptr)
+        {
+            treeContext->contentIndex->addSubtree(child.get());
+        }
+    }
+}
+
+// Writer-side lookup in the owning table, so the node stays alive for as long as the caller holds the directory mutex
+// or is the only writer. Concurrent lock-free readers go through getChild, which hands out ownership.
+FileSystemComponent *Directory::findChild(std::string_view name) const
+{
+    const ChildTable::Entry *foundChild = children.find(name);
+    if (foundChild != nullptr)
+    {
+        return foundChild->second.get();
+    }
+    return nullptr;
+}
+
+std::size_t Directory::getSnapshotBytes() const
+{
+    const ChildSnapshot *snapshot = publishedChildren.load(std::memory_order_acquire);
+    return snapshot != nullptr ? snapshot->allocatedBytes() : 0;
+}
+
+std::shared_ptr<FileSystemComponent> Directory::getChild(std::string_view name) const
+{
+    if (hasLockFreeReads())
+    {
+        EpochGuard guard;
+        const ChildSnapshot *snapshot = publishedChildren.load();
+        if (snapshot != nullptr)
+        {
+            const ChildSnapshot::Entry *foundChild = snapshot->find(name);
+            return foundChild != nullptr ? foundChild->second : nullptr;
+        }
+    }
+    const ChildTable::Entry *foundChild = children.find(name);
+    if (foundChild != nullptr)
+    {
+        return foundChild->second;
+    }
+    return nullptr;
 }
 
 void Directory::displayChildren()
 {
-    for (auto &child : children)
+    BufferedStreamSink sink;
+    displayChildren(sink);
+}
+
+void Directory::displayChildren(OutputSink &sink, const ListingCursor &cursor, const GlobPattern *pattern)
+{
+    forEachListedChild(cursor, pattern, [&sink](const ChildTable::Entry &child)
+                       { sink << child.first << '\n'; });
+}
+
+void Directory::forEachListedChild(const ListingCursor &cursor, const GlobPattern *pattern, const std::function<void(const ChildTable::Entry &)> &visitor) const
+{
+    std::string_view prefix = pattern != nullptr ? pattern->getLiteralPrefix() : std::string_view();
+    ChildTable::const_iterator child = cursor.after.empty() ? children.begin() : children.upperBound(cursor.after);
+    if (!prefix.empty() && (child == children.end() || child->first < prefix))
+    {
+        child = children.lowerBound(prefix);
+    }
+    else if (pattern == nullptr && cursor.after.empty())
+    {
+        child = children.atOffset(cursor.offset);
+    }
+    std::size_t skipped = pattern == nullptr && cursor.after.empty() ? cursor.offset : 0;
+    std::size_t listed = 0;
+    for (; child != children.end() && listed < cursor.limit; ++child)
+    {
+        if (!std::string_view(child->first).starts_with(prefix))
+        {
+            break;
+        }
+        if (pattern != nullptr && !pattern->matches(child->first))
+        {
+            continue;
+        }
+        if (skipped < cursor.offset)
+        {
+            ++skipped;
+            continue;
+        }
+        visitor(*child);
+        ++listed;
+    }
+}
+
+std::string_view Directory::extensionOf(std::string_view name)
+{
+    std::size_t dot = name.rfind('.');
+    return dot == std::string_view::npos ? std::string_view() : name.substr(dot + 1);
+}
+
+std::vector<FileSystemComponent *> Directory::findMatchingChildren(const GlobPattern &pattern) const
+{
+    std::vector<FileSystemComponent *> matches;
+    if (pattern.isLiteral())
+    {
+        if (FileSystemComponent *child = findChild(pattern.getLiteralText()))
+        {
+            matches.push_back(child);
+        }
+        return matches;
+    }
+    std::string_view suffixExtension = extensionOf(pattern.getLiteralSuffix());
+    if (pattern.isSuffixPattern() && !suffixExtension.empty())
     {
-        std::cout << child.first << std::endl;
+        auto extensionBucket = childrenByExtension.find(suffixExtension);
+        if (extensionBucket != childrenByExtension.end())
+        {
+            for (FileSystemComponent *child : extensionBucket->second)
+            {
+                if (suffixExtension.size() + 1 == pattern.getLiteralSuffix().size() || pattern.matches(child->getNameView()))
+                {
+                    matches.push_back(child);
+                }
+            }
+        }
+        return matches;
     }
+    auto [first, last] = children.prefixRange(pattern.getLiteralPrefix());
+    for (auto child = first; child != last; ++child)
+    {
+        if (pattern.matches(child->first))
+        {
+            matches.push_back(child->second.get());
+        }
+    }
+    return matches;
 }
 
 void Directory::removeChild(const std::string &directoryName)
 {
-    children.erase(directoryName);
+    const ChildTable::Entry *foundChild = children.find(directoryName);
+    if (foundChild != nullptr)
+    {
+        detachChild(foundChild->second);
+        children.erase(directoryName);
+        if (const ChildSnapshot *snapshot = publishedChildren.load())
+        {
+            publishChildren(snapshot->withoutChild(directoryName));
+        }
+    }
+}
+
+// Unlinks the child without walking it; the caller hands the subtree to a SubtreeReclaimer, which drops its index entries.
+std::shared_ptr<FileSystemComponent> Directory::detachSubtree(std::string_view name)
+{
+    const ChildTable::Entry *foundChild = children.find(name);
+    if (foundChild == nullptr)
+    {
+        return nullptr;
+    }
+    std::shared_ptr<FileSystemComponent> child = foundChild->second;
+    name = child->getNameView();
+    forgetExtension(child.get());
+    children.erase(name);
+    if (const ChildSnapshot *snapshot = publishedChildren.load())
+    {
+        publishChildren(snapshot->withoutChild(name));
+    }
+    std::unique_lock<std::shared_mutex> indexLock;
+    if (treeContext != nullptr)
+    {
+        indexLock = std::unique_lock<std::shared_mutex>(treeContext->indexMutex);
+        ++treeContext->generation;
+    }
+    child->setParent(nullptr);
+    return child;
+}
+
+void Directory::takeChildren(std::vector<std::shared_ptr<FileSystemComponent>> &taken)
+{
+    std::unique_lock<std::shared_mutex> writeLock(childrenMutex);
+    treeContext.reset();
+    for (auto &child : children)
+    {
+        taken.push_back(child.second);
+    }
+    children.clear();
+    childrenByExtension.clear();
+    publishChildren(nullptr);
+}
+
+void Directory::forgetExtension(FileSystemComponent *child)
+{
+    auto extensionBucket = childrenByExtension.find(extensionOf(child->getNameView()));
+    if (extensionBucket != childrenByExtension.end())
+    {
+        extensionBucket->second.erase(child);
+        if (extensionBucket->second.empty())
+        {
+            childrenByExtension.erase(extensionBucket);
+        }
+    }
+}
+
+void Directory::detachChild(const std::shared_ptr<FileSystemComponent> &child)
+{
+    forgetExtension(child.get());
+    if (treeContext != nullptr)
+    {
+        std::unique_lock<std::shared_mutex> indexLock(treeContext->indexMutex);
+        ++treeContext->generation;
+        treeContext->nameIndex.removeSubtree(child.get());
+        treeContext->timeIndex.removeSubtree(child.get());
+        if (treeContext->contentIndex != nullptr)
+        {
+            treeContext->contentIndex->removeSubtree(child.get());
+        }
+    }
+    child->setParent(nullptr);
+    if (Directory *childDirectory = asDirectory(child.get()))
+    {
+        childDirectory->setContext(nullptr);
+    }
+}
+
+void Directory::setContext(const std::shared_ptr<TreeContext> &context)
+{
+    treeContext = context;
+    for (auto &child : children)
+    {
+        Directory *childDirectory = asDirectory(child.second.get());
+        if (childDirectory != nullptr)
+        {
+            childDirectory->setContext(context);
+        }
+    }
+}
+
+void Directory::publishChildren(std::unique_ptr<ChildSnapshot> snapshot)
+{
+    const ChildSnapshot *previous = publishedChildren.exchange(snapshot.release());
+    if (previous != nullptr)
+    {
+        EpochDomain::instance().retire(previous);
+    }
+}
+
+void Directory::setLockFreeReads(bool enabled)
+{
+    std::unique_lock<std::shared_mutex> writeLock(childrenMutex);
+    publishChildren(enabled ? std::make_unique<ChildSnapshot>(children) : nullptr);
+    for (auto &child : children)
+    {
+        Directory *childDirectory = asDirectory(child.second.get());
+        if (childDirectory != nullptr)
+        {
+            childDirectory->setLockFreeReads(enabled);
+        }
+    }
 }
\ No newline at end of file
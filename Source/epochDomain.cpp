@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+#include "epochDomain.hpp"
+
+struct ThreadReaderState
+{
+    EpochDomain::ReaderRecord *record = nullptr;
+    std::size_t depth = 0;
+
+    ~ThreadReaderState()
+    {
+        if (record != nullptr)
+        {
+            EpochDomain::instance().releaseRecord(record);
+        }
+    }
+};
+
+static thread_local ThreadReaderState threadReader;
+
+EpochDomain &EpochDomain::instance()
+{
+    static EpochDomain domain;
+    return domain;
+}
+
+EpochDomain::~EpochDomain()
+{
+    for (RetiredObject &object : retired)
+    {
+        object.deleter(object.object);
+    }
+    ReaderRecord *record = readers.load();
+    while (record != nullptr)
+    {
+        ReaderRecord *next = record->next;
+        delete record;
+        record = next;
+    }
+}
+
+EpochDomain::ReaderRecord *EpochDomain::acquireRecord()
+{
+    for (ReaderRecord *record = readers.load(); record != nullptr; record = record->next)
+    {
+        bool expected = false;
+        if (!record->inUse.load(std::memory_order_relaxed) && record->inUse.compare_exchange_strong(expected, true))
+        {
+            return record;
+        }
+    }
+    ReaderRecord *record = new ReaderRecord;
+    record->inUse.store(true, std::memory_order_relaxed);
+    record->next = readers.load();
+    while (!readers.compare_exchange_weak(record->next, record))
+    {
+    }
+    return record;
+}
+
+void EpochDomain::releaseRecord(ReaderRecord *record)
+{
+    record->pinnedEpoch.store(0);
+    record->inUse.store(false, std::memory_order_release);
+}
+
+std::uint64_t EpochDomain::oldestPinnedEpoch() const
+{
+    std::uint64_t oldest = std::numeric_limits<std::uint64_t>::max();
+    for (ReaderRecord *record = readers.load(); record != nullptr; record = record->next)
+    {
+        std::uint64_t pinned = record->pinnedEpoch.load();
+        if (pinned != 0)
+        {
+            oldest = std::min(oldest, pinned);
+        }
+    }
+    return oldest;
+}
+
+void EpochDomain::retireObject(void *object, void (*deleter)(void *))
+{
+    std::uint64_t epoch = globalEpoch.fetch_add(1);
+    std::unique_lock<std::mutex> retiredLock(retiredMutex);
+    retired.push_back({epoch, object, deleter});
+    retiredCount.store(retired.size(), std::memory_order_relaxed);
+    if (retired.size() >= reclaimThreshold)
+    {
+        reclaim(retiredLock);
+    }
+}
+
+std::size_t EpochDomain::reclaim()
+{
+    std::unique_lock<std::mutex> retiredLock(retiredMutex);
+    return reclaim(retiredLock);
+}
+
+std::size_t EpochDomain::reclaim(std::unique_lock<std::mutex> &retiredLock)
+{
+    std::uint64_t oldest = oldestPinnedEpoch();
+    auto stillPinned = std::partition(retired.begin(), retired.end(), [oldest](const RetiredObject &object)
+                                      { return object.epoch >= oldest; });
+    std::vector<RetiredObject> reclaimable(stillPinned, retired.end());
+    retired.erase(stillPinned, retired.end());
+    retiredCount.store(retired.size(), std::memory_order_relaxed);
+    retiredLock.unlock();
+    for (RetiredObject &object : reclaimable)
+    {
+        object.deleter(object.object);
+    }
+    return reclaimable.size();
+}
+
+// Called as the last guard on a thread unpins, so a quiet domain does not sit on retired objects until the threshold.
+// Skips the work when nothing is retired or another thread is already reclaiming.
+void EpochDomain::reclaimOnExit()
+{
+    if (retiredCount.load(std::memory_order_relaxed) == 0)
+    {
+        return;
+    }
+    std::unique_lock<std::mutex> retiredLock(retiredMutex, std::try_to_lock);
+    if (retiredLock.owns_lock())
+    {
+        reclaim(retiredLock);
+    }
+}
+
+// Waits until every reader pinned before the call has left, then frees everything retired so far.
+void EpochDomain::synchronize()
+{
+    std::uint64_t epoch = globalEpoch.fetch_add(1);
+    while (oldestPinnedEpoch() <= epoch)
+    {
+        std::this_thread::yield();
+    }
+    reclaim();
+}
+
+std::size_t EpochDomain::pendingCount()
+{
+    std::lock_guard<std::mutex> retiredLock(retiredMutex);
+    return retired.size();
+}
+
+EpochGuard::EpochGuard()
+{
+    if (threadReader.depth++ == 0)
+    {
+        EpochDomain &domain = EpochDomain::instance();
+        if (threadReader.record == nullptr)
+        {
+            threadReader.record = domain.acquireRecord();
+        }
+        threadReader.record->pinnedEpoch.store(domain.globalEpoch.load());
+    }
+}
+
+EpochGuard::~EpochGuard()
+{
+    if (--threadReader.depth == 0)
+    {
+        threadReader.record->pinnedEpoch.store(0, std::memory_order_release);
+        EpochDomain::instance().reclaimOnExit();
+    }
+}
\ No newline at end of file
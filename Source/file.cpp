@@ -1,11 +1,42 @@
+#include <algorithm>
+
 #include "file.hpp"
+#include "directory.hpp"
+#include "instrumentation.hpp"
 
 void File::setContent(const std::string &contentString)
 {
-    content += contentString;
+    TreeContext *context = parentDirectory == nullptr ? nullptr : parentDirectory->getContext();
+    // The time index locks its own shards, so only content indexing needs the tree-wide index lock exclusively.
+    std::shared_lock<std::shared_mutex> sharedIndexLock;
+    std::unique_lock<std::shared_mutex> indexLock;
+    if (context != nullptr)
+    {
+        sharedIndexLock = std::shared_lock<std::shared_mutex>(context->indexMutex);
+        if (context->contentIndex != nullptr)
+        {
+            sharedIndexLock.unlock();
+            indexLock = std::unique_lock<std::shared_mutex>(context->indexMutex);
+        }
+    }
+    std::unique_lock<std::shared_mutex> contentLock(TreeContext::contentMutexFor(this));
+    Timestamp previousModificationTime = modificationTime;
+    modificationTime = currentTimestamp();
+    if (context != nullptr)
+    {
+        context->timeIndex.update(this, previousModificationTime, modificationTime);
+        if (context->contentIndex != nullptr)
+        {
+            std::size_t tailLength = std::min<std::size_t>(content.size(), ContentIndex::gramLength - 1);
+            std::string previousTail = content.read(content.size() - tailLength, tailLength);
+            context->contentIndex->addContent(this, previousTail, contentString);
+        }
+    }
+    content.append(contentString);
+    VFS_STATS(Instrumentation::count(StatCounter::BytesAppended, contentString.size()));
 }
 
 std::string File::getContent() const
 {
-    return content;
+    return content.toString();
 }
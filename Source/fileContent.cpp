@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <cstring>
+
+#include "fileContent.hpp"
+#include "contentSearch.hpp"
+#include "instrumentation.hpp"
+
+void FileContent::append(std::string_view text)
+{
+    totalSize += text.size();
+    if (!chunks.empty())
+    {
+        Chunk &lastChunk = chunks.back();
+        std::size_t copied = std::min(text.size(), lastChunk.capacity - lastChunk.size);
+        if (copied != 0)
+        {
+            std::memcpy(lastChunk.storage.get() + lastChunk.size, text.data(), copied);
+            lastChunk.size += copied;
+            text.remove_prefix(copied);
+        }
+    }
+    if (!text.empty())
+    {
+        VFS_STATS(Instrumentation::count(StatCounter::ChunkAllocations));
+        Chunk newChunk;
+        newChunk.capacity = std::max(text.size(), std::clamp(totalSize, smallestChunk, largestChunk));
+        newChunk.storage.reset(new char[newChunk.capacity]);
+        newChunk.data = newChunk.storage.get();
+        std::memcpy(newChunk.storage.get(), text.data(), text.size());
+        newChunk.size = text.size();
+        chunks.push_back(std::move(newChunk));
+    }
+}
+
+void FileContent::assignMapped(std::string_view extent, std::shared_ptr<const void> owner)
+{
+    clear();
+    if (!extent.empty())
+    {
+        Chunk mappedChunk;
+        mappedChunk.data = extent.data();
+        mappedChunk.size = extent.size();
+        mappedChunk.capacity = extent.size();
+        chunks.push_back(std::move(mappedChunk));
+        totalSize = extent.size();
+        mappingOwner = std::move(owner);
+    }
+}
+
+void FileContent::clear()
+{
+    chunks.clear();
+    totalSize = 0;
+    mappingOwner.reset();
+}
+
+std::size_t FileContent::allocatedBytes() const
+{
+    std::size_t bytes = 0;
+    for (auto &eachChunk : chunks)
+    {
+        if (eachChunk.storage != nullptr)
+        {
+            bytes += eachChunk.capacity;
+        }
+    }
+    return bytes;
+}
+
+std::size_t FileContent::read(std::size_t offset, std::span<char> destination) const
+{
+    std::size_t copied = 0;
+    for (auto &eachChunk : chunks)
+    {
+        if (copied == destination.size())
+        {
+            break;
+        }
+        if (offset >= eachChunk.size)
+        {
+            offset -= eachChunk.size;
+            continue;
+        }
+        std::size_t length = std::min(eachChunk.size - offset, destination.size() - copied);
+        std::memcpy(destination.data() + copied, eachChunk.data + offset, length);
+        copied += length;
+        offset = 0;
+    }
+    return copied;
+}
+
+std::string FileContent::read(std::size_t offset, std::size_t length) const
+{
+    if (offset >= totalSize)
+    {
+        return {};
+    }
+    std::string text(std::min(length, totalSize - offset), '\0');
+    read(offset, std::span<char>(text.data(), text.size()));
+    return text;
+}
+
+std::size_t FileContent::find(std::string_view needle, bool ignoreCase) const
+{
+    if (needle.empty())
+    {
+        return 0;
+    }
+    std::string carry;
+    std::size_t chunkOffset = 0;
+    for (auto &eachChunk : chunks)
+    {
+        std::string_view text = eachChunk.view();
+        if (!carry.empty())
+        {
+            std::string window = carry;
+            window.append(text.substr(0, needle.size() - 1));
+            std::size_t found = findSubstring(window, needle, ignoreCase);
+            if (found != std::string_view::npos)
+            {
+                return chunkOffset - carry.size() + found;
+            }
+        }
+        std::size_t found = findSubstring(text, needle, ignoreCase);
+        if (found != std::string_view::npos)
+        {
+            return chunkOffset + found;
+        }
+        if (text.size() >= needle.size() - 1)
+        {
+            carry.assign(text.substr(text.size() - (needle.size() - 1)));
+        }
+        else
+        {
+            carry.append(text);
+            if (carry.size() >= needle.size())
+            {
+                carry.erase(0, carry.size() - (needle.size() - 1));
+            }
+        }
+        chunkOffset += text.size();
+    }
+    return npos;
+}
+
+std::string FileContent::toString() const
+{
+    std::string text;
+    text.reserve(totalSize);
+    forEachChunk([&text](std::string_view eachChunk)
+                 { text.append(eachChunk); });
+    return text;
+}
\ No newline at end of file
@@ -1,28 +1,66 @@
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+
 #include "fileSystem.hpp"
+#include "snapshot.hpp"
 
-void FileSystem::createDirectory(const std::string &path)
+FsResult<Directory *> FileSystem::createDirectories(const std::string &path)
 {
-    std::shared_ptr<Directory> presentWorkingDirectory = workingDirectory;
-    std::istringstream pathStream(path);
-    std::vector<std::string> directories;
-    directories = splitPath(pathStream, '/');
-    for (auto &directory : directories)
+    VFS_TIME_OPERATION(StatOperation::CreateDirectory);
+    PathTokenizer tokenizer(path);
+    Directory *currentDirectory = tokenizer.isAbsolute() ? rootDirectory.get() : workingDirectory.get();
+    std::shared_ptr<Directory> newDirectory;
+    std::string_view directory;
+    while (tokenizer.next(directory))
     {
-        std::unordered_map<std::string, std::shared_ptr<FileSystemComponent>> subDirectories;
-        subDirectories = workingDirectory->getSubDirectories();
-        auto foundDirectory = subDirectories.find(directory);
-        if (foundDirectory != subDirectories.end())
+        if (directory == "..")
+        {
+            if (currentDirectory != rootDirectory.get() && currentDirectory->getParent() != nullptr)
+            {
+                currentDirectory = currentDirectory->getParent();
+            }
+            continue;
+        }
+        FileSystemComponent *foundDirectory = currentDirectory->findChild(directory);
+        if (foundDirectory != nullptr)
+        {
+            currentDirectory = asDirectory(foundDirectory);
+            if (currentDirectory == nullptr)
+            {
+                return FsResult<Directory *>::failure(FsStatus::NotADirectory, std::string(directory));
+            }
+        }
+        else if (!isValidNodeName(directory))
         {
-            workingDirectory = std::dynamic_pointer_cast<Directory>(foundDirectory->second);
+            return FsResult<Directory *>::failure(FsStatus::InvalidArgument, std::string(directory));
         }
         else
         {
-            std::shared_ptr<Directory> newDirectory = std::make_shared<Directory>(directory);
-            workingDirectory->addChild(newDirectory);
-            workingDirectory = newDirectory;
+            newDirectory = makeDirectory(std::string(directory));
+            currentDirectory->addChild(newDirectory);
+            currentDirectory = newDirectory.get();
+            if (journal != nullptr && !journalOperation(JournalOperation::CreateDirectory, getPathOf(currentDirectory), currentDirectory->getCreationTime()))
+            {
+                return FsResult<Directory *>::failure(FsStatus::IoError, "journal");
+            }
         }
     }
-    workingDirectory = presentWorkingDirectory;
+    return FsResult<Directory *>::success(currentDirectory);
+}
+
+void FileSystem::createDirectory(const std::string &path)
+{
+    SinkFlushGuard flushOnReturn(*outputSink);
+    FsResult<Directory *> created = createDirectories(path);
+    if (created.status == FsStatus::InvalidArgument)
+    {
+        *outputSink << "Invalid name: " << created.detail << '\n';
+    }
+    else if (!created.ok())
+    {
+        *outputSink << "Directory not found:" << created.detail << '\n';
+    }
 }
 
 std::vector<std::string> FileSystem::splitPath(std::istringstream &path, const char &delimiter)
@@ -36,351 +74,1229 @@ std::vector<std::string> FileSystem::splitPath(std::istringstream &path, const c
     return directories;
 }
 
+FsResult<Directory *> FileSystem::resolveParentDirectory(const std::string &path, std::string_view &leafName)
+{
+    ResolvedPath parentDirectory = pathResolver.resolveParent(path, rootDirectory.get(), workingDirectory.get(), leafName);
+    if (parentDirectory.invalidLeaf)
+    {
+        return FsResult<Directory *>::failure(FsStatus::InvalidArgument, std::string(leafName));
+    }
+    if (parentDirectory.component == nullptr)
+    {
+        return FsResult<Directory *>::failure(FsStatus::PathNotFound, std::string(parentDirectory.missingSegment));
+    }
+    return FsResult<Directory *>::success(static_cast<Directory *>(parentDirectory.component));
+}
+
+FsResult<Directory *> FileSystem::resolveDirectory(const std::string &path)
+{
+    if (path.empty() || path == " ")
+    {
+        return FsResult<Directory *>::success(workingDirectory.get());
+    }
+    ResolvedPath foundDirectory = pathResolver.resolve(path, rootDirectory.get(), workingDirectory.get());
+    if (foundDirectory.component == nullptr)
+    {
+        return FsResult<Directory *>::failure(FsStatus::PathNotFound, std::string(foundDirectory.missingSegment));
+    }
+    if (!foundDirectory.component->isDirectory())
+    {
+        return FsResult<Directory *>::failure(FsStatus::NotADirectory, path);
+    }
+    return FsResult<Directory *>::success(static_cast<Directory *>(foundDirectory.component));
+}
+
+FsResult<Directory *> FileSystem::enterDirectory(const std::string &path)
+{
+    VFS_TIME_OPERATION(StatOperation::ChangeDirectory);
+    FsResult<Directory *> target = path == " " ? FsResult<Directory *>::success(rootDirectory.get()) : resolveDirectory(path);
+    if (target.ok())
+    {
+        workingDirectory = target.value->shared_from_this();
+    }
+    return target;
+}
+
 void FileSystem::changeDirectory(const std::string &path)
 {
-    if (path == " ")
+    SinkFlushGuard flushOnReturn(*outputSink);
+    FsResult<Directory *> entered = enterDirectory(path);
+    if (!entered.ok())
     {
-        workingDirectory = rootDirectory;
-        pathOfWorkingDirectory = "~";
-        return;
+        *outputSink << "Directory not found: " << entered.detail << '\n';
     }
-    else
+}
+
+void FileSystem::moveUpDirectory()
+{
+    Directory *parentDirectory = workingDirectory->getParent();
+    if (workingDirectory != rootDirectory && parentDirectory != nullptr)
+    {
+        workingDirectory = parentDirectory->shared_from_this();
+    }
+}
+
+std::string FileSystem::getPathOf(FileSystemComponent *component) const
+{
+    std::vector<FileSystemComponent *> ancestors;
+    while (component != nullptr && component != rootDirectory.get() && component->getParent() != nullptr)
+    {
+        ancestors.push_back(component);
+        component = component->getParent();
+    }
+    std::string path = "~";
+    for (auto ancestor = ancestors.rbegin(); ancestor != ancestors.rend(); ++ancestor)
+    {
+        path += '/';
+        path += (*ancestor)->getNameView();
+    }
+    return path;
+}
+
+FsResult<File *> FileSystem::createFileAt(const std::string &path)
+{
+    VFS_TIME_OPERATION(StatOperation::CreateFile);
+    std::string_view name;
+    FsResult<Directory *> parentDirectory = resolveParentDirectory(path, name);
+    if (!parentDirectory.ok())
+    {
+        return FsResult<File *>::failure(parentDirectory.status, std::move(parentDirectory.detail));
+    }
+    std::shared_ptr<File> file = makeFile(std::string(name));
+    parentDirectory.value->addChild(file);
+    if (journal != nullptr && !journalOperation(JournalOperation::CreateFile, getPathOf(file.get()), file->getCreationTime()))
+    {
+        return FsResult<File *>::failure(FsStatus::IoError, "journal");
+    }
+    return FsResult<File *>::success(file.get());
+}
+
+void FileSystem::createFile(const std::string &path)
+{
+    SinkFlushGuard flushOnReturn(*outputSink);
+    FsResult<File *> created = createFileAt(path);
+    if (created.status == FsStatus::InvalidArgument)
+    {
+        *outputSink << "Invalid name: " << created.detail << '\n';
+    }
+    else if (!created.ok())
+    {
+        *outputSink << "Directory not found:" << created.detail << '\n';
+    }
+}
+
+FsResult<File *> FileSystem::findFileAt(const std::string &path)
+{
+    std::string_view fileName;
+    FsResult<Directory *> parentDirectory = resolveParentDirectory(path, fileName);
+    if (!parentDirectory.ok())
+    {
+        return FsResult<File *>::failure(parentDirectory.status, std::move(parentDirectory.detail));
+    }
+    FileSystemComponent *findFile = parentDirectory.value->findChild(fileName);
+    if (findFile == nullptr)
+    {
+        return FsResult<File *>::failure(FsStatus::NotFound, std::string(fileName));
+    }
+    if (!findFile->isFile())
     {
-        std::istringstream pathStream(path);
-        std::vector<std::string> directoriesToTraverse = splitPath(pathStream, '/');
-        for (auto &directory : directoriesToTraverse)
+        return FsResult<File *>::failure(FsStatus::NotAFile, std::string(fileName));
+    }
+    return FsResult<File *>::success(static_cast<File *>(findFile));
+}
+
+FsResult<File *> FileSystem::appendToFile(const std::string &path, const std::string &text)
+{
+    VFS_TIME_OPERATION(StatOperation::Append);
+    FsResult<File *> file = findFileAt(path);
+    if (file.ok())
+    {
+        file.value->setContent(text);
+        if (journal != nullptr && !journalOperation(JournalOperation::Append, getPathOf(file.value), file.value->getModificationTime(), text))
         {
-            if (directory == "..")
-            {
-                if (workingDirectory == rootDirectory)
-                {
-                    break;
-                }
-                moveUpDirectory();
-                continue;
-            }
-            std::unordered_map<std::string, std::shared_ptr<FileSystemComponent>> subDirectories;
-            subDirectories = workingDirectory->getSubDirectories();
-            auto foundDirectory = subDirectories.find(directory);
-            if (foundDirectory != subDirectories.end() && (foundDirectory->second)->getComponentType() == "Directory")
-            {
-                workingDirectory = std::dynamic_pointer_cast<Directory>(foundDirectory->second);
-                pathOfWorkingDirectory += ("/" + foundDirectory->first);
-            }
-            else if (foundDirectory == subDirectories.end() || (foundDirectory->second)->getComponentType() == "File")
-            {
-                std::cout << "Directory not found: " << directory << std::endl;
-                break;
-            }
+            return FsResult<File *>::failure(FsStatus::IoError, "journal");
         }
     }
+    return file;
 }
 
-void FileSystem::moveUpDirectory()
+FsResult<const FileContent *> FileSystem::readFile(const std::string &path)
+{
+    VFS_TIME_OPERATION(StatOperation::Read);
+    FsResult<File *> file = findFileAt(path);
+    if (!file.ok())
+    {
+        return FsResult<const FileContent *>::failure(file.status, std::move(file.detail));
+    }
+    return FsResult<const FileContent *>::success(&file.value->getFileContent());
+}
+
+void FileSystem::writeToFile(const std::string &path)
+{
+    SinkFlushGuard flushOnReturn(*outputSink);
+    std::string_view fileName;
+    FsResult<Directory *> parentDirectory = resolveParentDirectory(path, fileName);
+    if (!parentDirectory.ok())
+    {
+        *outputSink << "Directory not found:" << parentDirectory.detail << '\n';
+        return;
+    }
+    *outputSink << "\033[s";
+    *outputSink << "\033[?1049h";
+    *outputSink << "\033[H";
+    *outputSink << "\033[J";
+    *outputSink << "fileoperation" << '\n';
+    outputSink->flush();
+    std::ostringstream contentsToInsertToFile;
+    std::string line{};
+    while (std::getline(std::cin, line) && line != "exit")
+    {
+        contentsToInsertToFile << line << "\n";
+    }
+    *outputSink << "\033[?1049l";
+    *outputSink << "\033[u";
+
+    if (!appendToFile(path, contentsToInsertToFile.str()).ok())
+    {
+        *outputSink << "File not found" << '\n';
+    }
+}
+
+void FileSystem::displayFileContent(const std::string &path)
+{
+    SinkFlushGuard flushOnReturn(*outputSink);
+    FsResult<const FileContent *> content = readFile(path);
+    if (content.ok())
+    {
+        *outputSink << "File Content\n";
+        content.value->forEachChunk([this](std::string_view chunk)
+                                    { outputSink->write(chunk); });
+        *outputSink << '\n';
+    }
+    else if (content.status == FsStatus::PathNotFound)
+    {
+        *outputSink << "Directory not found:" << content.detail << '\n';
+    }
+    else
+    {
+        *outputSink << "File not found" << '\n';
+    }
+}
+
+void FileSystem::displayFiles()
 {
-    if (workingDirectory != rootDirectory)
+    VFS_TIME_OPERATION(StatOperation::List);
+    SinkFlushGuard flushOnReturn(*outputSink);
+    workingDirectory->displayChildren(*outputSink);
+}
+
+static void parseListingArguments(const std::string &arguments, ListingCursor &cursor, std::string &pattern)
+{
+    std::string option;
+    std::istringstream argumentStream(arguments);
+    while (argumentStream >> option)
     {
-        std::istringstream path(pathOfWorkingDirectory);
-        std::vector<std::string> parentDirectories = splitPath(path, '/');
-        if (!parentDirectories.empty())
+        if (option == "-offset")
         {
-            parentDirectories.pop_back();
+            argumentStream >> cursor.offset;
         }
-        if (!parentDirectories.empty())
+        else if (option == "-limit")
         {
-            parentDirectories.erase(parentDirectories.begin());
+            argumentStream >> cursor.limit;
         }
-        auto parentDirectory = rootDirectory;
-        pathOfWorkingDirectory = "~";
-        if (!parentDirectories.empty())
+        else if (option == "-after")
         {
-            std::string parentDirectoryName = parentDirectories.back();
-            for (auto &directory : parentDirectories)
-            {
-                std::unordered_map<std::string, std::shared_ptr<FileSystemComponent>> subDirectories;
-                subDirectories = parentDirectory->getSubDirectories();
-
-                auto findDirectory = subDirectories.find(directory);
-
-                parentDirectory = std::dynamic_pointer_cast<Directory>(findDirectory->second);
-                pathOfWorkingDirectory += ("/" + directory);
-            }
+            argumentStream >> cursor.after;
+        }
+        else
+        {
+            pattern = option;
         }
-        workingDirectory = parentDirectory;
     }
 }
 
-void FileSystem::createFile(const std::string &path)
+void FileSystem::listFiles(const std::string &arguments)
 {
-    std::shared_ptr<Directory> presentWorkingDirectory = workingDirectory;
-    std::istringstream pathStream(path);
-    std::vector<std::string> directories;
-    directories = splitPath(pathStream, '/');
-    std::string name;
-    if (!directories.empty())
+    VFS_TIME_OPERATION(StatOperation::List);
+    SinkFlushGuard flushOnReturn(*outputSink);
+    ListingCursor cursor;
+    std::string pattern;
+    parseListingArguments(arguments, cursor, pattern);
+    if (pattern.empty())
+    {
+        workingDirectory->displayChildren(*outputSink, cursor);
+    }
+    else
+    {
+        GlobPattern compiledPattern(pattern);
+        workingDirectory->displayChildren(*outputSink, cursor, &compiledPattern);
+    }
+}
+
+FsResult<std::vector<std::string>> FileSystem::listDirectory(const std::string &path, const ListingCursor &cursor, const std::string &pattern)
+{
+    VFS_TIME_OPERATION(StatOperation::List);
+    FsResult<Directory *> directory = resolveDirectory(path);
+    if (!directory.ok())
+    {
+        return FsResult<std::vector<std::string>>::failure(directory.status, std::move(directory.detail));
+    }
+    std::vector<std::string> names;
+    std::optional<GlobPattern> compiledPattern;
+    if (!pattern.empty())
     {
-        name = directories.back();
-        directories.erase(directories.end());
+        compiledPattern.emplace(pattern);
     }
-    if (!directories.empty())
+    directory.value->forEachListedChild(cursor, compiledPattern ? &*compiledPattern : nullptr, [&names](const ChildTable::Entry &child)
+                                        { names.push_back(child.first.str()); });
+    return FsResult<std::vector<std::string>>::success(std::move(names));
+}
+
+static bool isWithin(const FileSystemComponent *component, const FileSystemComponent *ancestor)
+{
+    for (; component != nullptr; component = component->getParent())
     {
-        for (auto &directory : directories)
+        if (component == ancestor)
         {
-            std::unordered_map<std::string, std::shared_ptr<FileSystemComponent>> subDirectories;
-            subDirectories = workingDirectory->getSubDirectories();
-            auto foundDirectory = subDirectories.find(directory);
-            if (foundDirectory != subDirectories.end())
-            {
-                workingDirectory = std::dynamic_pointer_cast<Directory>(foundDirectory->second);
-            }
-            else
-            {
-                std::cout << "Directory not found:" << directory << std::endl;
-                return;
-            }
+            return true;
         }
     }
-    std::shared_ptr<File> file = std::make_shared<File>(name);
-    workingDirectory->addChild(file);
-    workingDirectory = presentWorkingDirectory;
+    return false;
 }
 
-void FileSystem::writeToFile(const std::string &path)
+static bool takeRecursiveFlag(const std::string &arguments, std::string &path)
 {
-    std::shared_ptr<Directory> presentWorkingDirectory = workingDirectory;
-    std::istringstream pathStream(path);
-    std::vector<std::string> directories;
-    directories = splitPath(pathStream, '/');
-    std::string fileName = directories.back();
-    directories.erase(directories.end());
-    if (!directories.empty())
+    if (arguments != "-r" && arguments.rfind("-r ", 0) != 0)
+    {
+        path = arguments;
+        return false;
+    }
+    std::size_t pathStart = arguments.find_first_not_of(' ', 2);
+    path = pathStart == std::string::npos ? std::string() : arguments.substr(pathStart);
+    return true;
+}
+
+void FileSystem::detachAndReclaim(Directory &parent, std::string_view name)
+{
+    std::shared_ptr<FileSystemComponent> subtree = parent.detachSubtree(name);
+    if (isWithin(workingDirectory.get(), subtree.get()))
+    {
+        workingDirectory = parent.shared_from_this();
+    }
+    subtreeReclaimer.submit(std::move(subtree), parent.getSharedContext());
+}
+
+FsResult<> FileSystem::deleteDirectory(const std::string &path, bool recursive)
+{
+    VFS_TIME_OPERATION(StatOperation::RemoveDirectory);
+    std::string_view directoryName;
+    FsResult<Directory *> parentDirectory = resolveParentDirectory(path, directoryName);
+    if (!parentDirectory.ok())
+    {
+        return FsResult<>::failure(parentDirectory.status, std::move(parentDirectory.detail));
+    }
+    FileSystemComponent *findDirectory = parentDirectory.value->findChild(directoryName);
+    if (findDirectory == nullptr)
+    {
+        return FsResult<>::failure(FsStatus::NotFound, std::string(directoryName));
+    }
+    Directory *directory = asDirectory(findDirectory);
+    if (directory == nullptr)
+    {
+        return FsResult<>::failure(FsStatus::NotADirectory, std::string(directoryName));
+    }
+    if (!recursive && !directory->getChildren().empty())
+    {
+        return FsResult<>::failure(FsStatus::DirectoryNotEmpty, std::string(directoryName));
+    }
+    std::string removedPath = journal != nullptr ? getPathOf(directory) : std::string();
+    if (recursive)
+    {
+        detachAndReclaim(*parentDirectory.value, directoryName);
+    }
+    else
+    {
+        parentDirectory.value->removeChild(std::string(directoryName));
+    }
+    if (journal != nullptr && !journalOperation(recursive ? JournalOperation::RemoveDirectoryTree : JournalOperation::RemoveDirectory, removedPath, currentTimestamp()))
+    {
+        return FsResult<>::failure(FsStatus::IoError, "journal");
+    }
+    return FsResult<>::success({});
+}
+
+void FileSystem::removeDirectory(const std::string &arguments)
+{
+    SinkFlushGuard flushOnReturn(*outputSink);
+    std::string directoryName;
+    bool recursive = takeRecursiveFlag(arguments, directoryName);
+    FsResult<> removed = deleteDirectory(directoryName, recursive);
+    switch (removed.status)
     {
-        for (auto &directory : directories)
+    case FsStatus::Ok:
+        break;
+    case FsStatus::NotFound:
+    case FsStatus::PathNotFound:
+        *outputSink << "Directory not found" << '\n';
+        break;
+    case FsStatus::NotADirectory:
+        *outputSink << "Not a directory: " << removed.detail << '\n';
+        break;
+    case FsStatus::DirectoryNotEmpty:
+        *outputSink << "Directory not empty" << '\n';
+        break;
+    case FsStatus::InvalidArgument:
+        *outputSink << "Invalid name: " << removed.detail << '\n';
+        break;
+    default:
+        *outputSink << "Cannot remove directory: " << removed.detail << " (" << describeStatus(removed.status) << ")\n";
+        break;
+    }
+}
+
+FsResult<std::size_t> FileSystem::deleteFiles(const std::string &pattern, bool recursive)
+{
+    VFS_TIME_OPERATION(StatOperation::RemoveFiles);
+    std::string_view leafPattern;
+    FsResult<Directory *> parentDirectory = resolveParentDirectory(pattern, leafPattern);
+    if (!parentDirectory.ok())
+    {
+        return FsResult<std::size_t>::failure(parentDirectory.status, std::move(parentDirectory.detail));
+    }
+    Directory *directory = parentDirectory.value;
+    std::size_t removedCount = 0;
+    if (GlobPattern::hasWildcards(leafPattern))
+    {
+        for (FileSystemComponent *child : directory->findMatchingChildren(GlobPattern(leafPattern)))
         {
-            std::unordered_map<std::string, std::shared_ptr<FileSystemComponent>> subDirectories;
-            subDirectories = workingDirectory->getSubDirectories();
-            auto foundDirectory = subDirectories.find(directory);
-            if (foundDirectory != subDirectories.end())
+            if (child->isFile())
             {
-                workingDirectory = std::dynamic_pointer_cast<Directory>(foundDirectory->second);
+                directory->removeChild(child->getName());
+                ++removedCount;
             }
-            else
+            else if (recursive)
             {
-                std::cout << "Directory not found:" << directory << std::endl;
-                return;
+                detachAndReclaim(*directory, child->getNameView());
+                ++removedCount;
             }
         }
     }
-    std::cout << "\033[s";
-    std::cout << "\033[?1049h";
-    std::cout << "\033[H";
-    std::cout << "\033[J";
-    std::cout << "fileoperation" << std::endl;
-    std::ostringstream contentsToInsertToFile;
-    std::string line{};
-    while (std::getline(std::cin, line) && line != "exit")
+    else
     {
-        contentsToInsertToFile << line << "\n";
+        FileSystemComponent *findFile = directory->findChild(leafPattern);
+        if (findFile != nullptr && findFile->isFile())
+        {
+            directory->removeChild(std::string(leafPattern));
+            ++removedCount;
+        }
+        else if (findFile != nullptr && recursive)
+        {
+            detachAndReclaim(*directory, leafPattern);
+            ++removedCount;
+        }
+    }
+    if (removedCount == 0)
+    {
+        return FsResult<std::size_t>::failure(FsStatus::NotFound, std::string(leafPattern));
     }
-    std::cout << "\033[?1049l";
-    std::cout << "\033[u";
+    if (journal != nullptr && !journalOperation(recursive ? JournalOperation::RemoveFilesRecursive : JournalOperation::RemoveFiles, getPathOf(directory) + "/" + std::string(leafPattern), currentTimestamp()))
+    {
+        return FsResult<std::size_t>::failure(FsStatus::IoError, "journal");
+    }
+    return FsResult<std::size_t>::success(removedCount);
+}
 
-    std::unordered_map<std::string, std::shared_ptr<FileSystemComponent>> subDirectories;
-    subDirectories = workingDirectory->getSubDirectories();
-    auto findFile = subDirectories.find(fileName);
-    if (findFile != subDirectories.end() && (findFile->second)->getComponentType() == "File")
+void FileSystem::removeFile(const std::string &arguments)
+{
+    SinkFlushGuard flushOnReturn(*outputSink);
+    std::string fileName;
+    bool recursive = takeRecursiveFlag(arguments, fileName);
+    if (!deleteFiles(fileName, recursive).ok())
     {
-        std::shared_ptr<File> file = std::dynamic_pointer_cast<File>(findFile->second);
-        file->setContent(contentsToInsertToFile.str());
+        *outputSink << "File not found" << '\n';
     }
-    else
+}
+
+void FileSystem::fileFound(const std::string &fileName, const std::pair<std::string, std::shared_ptr<FileSystemComponent>> &fileComponent, std::string currentPath)
+{
+    SinkFlushGuard flushOnReturn(*outputSink);
+    if (fileComponent.second->isFile() && fileComponent.first == fileName)
     {
-        std::cout << "File not found" << std::endl;
+        *outputSink << currentPath << "/" << fileComponent.first << '\n';
         return;
     }
+    else if (fileComponent.second->isDirectory())
+    {
+        appendPath(currentPath, fileComponent.first);
+        std::vector<std::string> foundPaths;
+        collectByName(fileName, static_cast<const Directory &>(*fileComponent.second), currentPath, foundPaths);
+        printSortedPaths(foundPaths);
+    }
+}
 
-    workingDirectory = presentWorkingDirectory;
+void FileSystem::collectByName(const std::string &fileName, const Directory &directory, const std::string &currentPath, std::vector<std::string> &foundPaths)
+{
+    if (GlobPattern::hasWildcards(fileName))
+    {
+        collectByGlob(GlobPattern(fileName), directory, currentPath, foundPaths);
+        return;
+    }
+    auto nameMatches = [&fileName](std::string_view name, const FileSystemComponent &)
+    { return name == fileName; };
+    if (!findWithNameIndex(fileName, directory, currentPath, foundPaths) && !findInParallel(directory, currentPath, nameMatches, foundPaths))
+    {
+        std::string path = currentPath;
+        walkByName(fileName, directory, path, foundPaths);
+    }
 }
 
-void FileSystem::displayFileContent(const std::string &path)
+void FileSystem::walkByName(const std::string &fileName, const Directory &directory, std::string &currentPath, std::vector<std::string> &foundPaths)
 {
-    std::shared_ptr<Directory> presentWorkingDirectory = workingDirectory;
-    std::istringstream pathStream(path);
-    std::vector<std::string> directories;
-    directories = splitPath(pathStream, '/');
-    std::string fileName = directories.back();
-    directories.erase(directories.end());
-    if (!directories.empty())
+    std::shared_lock<std::shared_mutex> directoryLock(directory.getMutex());
+    VFS_STATS(Instrumentation::addFindVisits(directory.getChildren().size()));
+    for (auto &file : directory.getChildren())
     {
-        for (auto &directory : directories)
+        if (file.second->isFile() && file.first == fileName)
         {
-            std::unordered_map<std::string, std::shared_ptr<FileSystemComponent>> subDirectories;
-            subDirectories = workingDirectory->getSubDirectories();
-            auto foundDirectory = subDirectories.find(directory);
-            if (foundDirectory != subDirectories.end())
-            {
-                workingDirectory = std::dynamic_pointer_cast<Directory>(foundDirectory->second);
-            }
-            else
+            foundPaths.push_back(currentPath + "/" + file.first);
+        }
+        else if (file.second->isDirectory())
+        {
+            std::size_t pathLength = currentPath.size();
+            appendPath(currentPath, file.first);
+            walkByName(fileName, static_cast<const Directory &>(*file.second), currentPath, foundPaths);
+            currentPath.resize(pathLength);
+        }
+    }
+}
+
+void FileSystem::findByTime(const int &range, const std::pair<std::string, std::shared_ptr<FileSystemComponent>> &fileComponent, std::string currentPath)
+{
+    SinkFlushGuard flushOnReturn(*outputSink);
+    Timestamp cutoff = currentTimestamp() - std::chrono::seconds(range);
+    if (fileComponent.second->isFile())
+    {
+        if (modifiedSince(cutoff, *fileComponent.second))
+        {
+            *outputSink << currentPath << "/" << fileComponent.first << '\n';
+            return;
+        }
+    }
+    else if (fileComponent.second->isDirectory())
+    {
+        appendPath(currentPath, fileComponent.first);
+        std::vector<std::string> foundPaths;
+        collectByTime(cutoff, static_cast<const Directory &>(*fileComponent.second), currentPath, foundPaths);
+        printSortedPaths(foundPaths);
+    }
+}
+
+void FileSystem::collectByTime(Timestamp cutoff, const Directory &directory, const std::string &currentPath, std::vector<std::string> &foundPaths)
+{
+    auto timeMatches = [cutoff](std::string_view, const FileSystemComponent &file)
+    { return modifiedSince(cutoff, file); };
+    if (!findWithTimeIndex(cutoff, directory, currentPath, foundPaths) && !findInParallel(directory, currentPath, timeMatches, foundPaths))
+    {
+        std::string path = currentPath;
+        walkByTime(cutoff, directory, path, foundPaths);
+    }
+}
+
+void FileSystem::walkByTime(Timestamp cutoff, const Directory &directory, std::string &currentPath, std::vector<std::string> &foundPaths)
+{
+    std::shared_lock<std::shared_mutex> directoryLock(directory.getMutex());
+    VFS_STATS(Instrumentation::addFindVisits(directory.getChildren().size()));
+    for (auto &file : directory.getChildren())
+    {
+        if (file.second->isFile())
+        {
+            if (modifiedSince(cutoff, *file.second))
             {
-                std::cout << "Directory not found:" << directory << std::endl;
-                return;
+                foundPaths.push_back(currentPath + "/" + file.first);
             }
         }
+        else if (file.second->isDirectory())
+        {
+            std::size_t pathLength = currentPath.size();
+            appendPath(currentPath, file.first);
+            walkByTime(cutoff, static_cast<const Directory &>(*file.second), currentPath, foundPaths);
+            currentPath.resize(pathLength);
+        }
     }
-    std::unordered_map<std::string, std::shared_ptr<FileSystemComponent>> subDirectories;
-    subDirectories = workingDirectory->getSubDirectories();
-    auto findFile = subDirectories.find(fileName);
-    if (findFile != subDirectories.end() && (findFile->second)->getComponentType() == "File")
+}
+
+void FileSystem::findByContent(const std::string &content, const std::pair<std::string, std::shared_ptr<FileSystemComponent>> &fileComponent, std::string currentPath)
+{
+    SinkFlushGuard flushOnReturn(*outputSink);
+    ContentMatcher matcher(content, ignoreContentCase);
+    if (fileComponent.second->isFile())
     {
-        std::shared_ptr<File> file = std::dynamic_pointer_cast<File>(findFile->second);
-        std::string fileContent = file->getContent();
-        std::cout << "File Content\n"
-                  << fileContent << std::endl;
+        File &file = static_cast<File &>(*fileComponent.second);
+        if (contentMatches(matcher, file))
+        {
+            *outputSink << currentPath << "/" << fileComponent.first << '\n';
+            return;
+        }
     }
-    else
+    else if (fileComponent.second->isDirectory())
     {
-        std::cout << "File not found" << std::endl;
-        return;
+        appendPath(currentPath, fileComponent.first);
+        std::vector<std::string> foundPaths;
+        collectByContent(matcher, static_cast<const Directory &>(*fileComponent.second), currentPath, foundPaths);
+        printSortedPaths(foundPaths);
     }
-    workingDirectory = presentWorkingDirectory;
 }
 
-void FileSystem::displayFiles()
+void FileSystem::collectByContent(const ContentMatcher &matcher, const Directory &directory, const std::string &currentPath, std::vector<std::string> &foundPaths)
 {
-    workingDirectory->displayChildren();
+    auto fileMatches = [&matcher](std::string_view, const FileSystemComponent &file)
+    { return contentMatches(matcher, static_cast<const File &>(file)); };
+    if (!findWithContentIndex(matcher, directory, currentPath, foundPaths) && !findInParallel(directory, currentPath, fileMatches, foundPaths))
+    {
+        std::string path = currentPath;
+        walkByContent(matcher, directory, path, foundPaths);
+    }
 }
 
-void FileSystem::removeDirectory(const std::string &directoryName)
+void FileSystem::walkByContent(const ContentMatcher &matcher, const Directory &directory, std::string &currentPath, std::vector<std::string> &foundPaths)
 {
-    auto subDirectories = workingDirectory->getSubDirectories();
-    auto findDirectory = subDirectories.find(directoryName);
-    if (findDirectory != subDirectories.end())
+    std::shared_lock<std::shared_mutex> directoryLock(directory.getMutex());
+    VFS_STATS(Instrumentation::addFindVisits(directory.getChildren().size()));
+    for (auto &file : directory.getChildren())
     {
-        auto directory = std::dynamic_pointer_cast<Directory>(findDirectory->second);
-        if (directory->getSubDirectories().empty() && directory->getComponentType() == "Directory")
+        if (file.second->isFile())
         {
-            workingDirectory->removeChild(findDirectory->first);
+            const File &foundFile = static_cast<const File &>(*file.second);
+            if (contentMatches(matcher, foundFile))
+            {
+                foundPaths.push_back(currentPath + "/" + file.first);
+            }
         }
-        else
+        else if (file.second->isDirectory())
         {
-            std::cout << "Directory not empty" << std::endl;
+            std::size_t pathLength = currentPath.size();
+            appendPath(currentPath, file.first);
+            walkByContent(matcher, static_cast<const Directory &>(*file.second), currentPath, foundPaths);
+            currentPath.resize(pathLength);
         }
     }
+}
+
+FsResult<std::vector<std::string>> FileSystem::find(const FindQuery &query)
+{
+    FsResult<Directory *> startDirectory = resolveDirectory(query.startPath);
+    if (!startDirectory.ok())
+    {
+        return FsResult<std::vector<std::string>>::failure(startDirectory.status, std::move(startDirectory.detail));
+    }
+    return findUnder(query, *startDirectory.value, getPathOf(startDirectory.value));
+}
+
+FsResult<std::vector<std::string>> FileSystem::findUnder(const FindQuery &query, const Directory &startDirectory, const std::string &startPath)
+{
+    VFS_TIME_OPERATION(StatOperation::Find);
+    std::vector<std::string> foundPaths;
+    switch (query.kind)
+    {
+    case FindKind::Name:
+        collectByName(query.pattern, startDirectory, startPath, foundPaths);
+        break;
+    case FindKind::ModifiedWithin:
+        collectByTime(currentTimestamp() - query.range, startDirectory, startPath, foundPaths);
+        break;
+    case FindKind::Content:
+        collectByContent(ContentMatcher(query.pattern, query.ignoreCase), startDirectory, startPath, foundPaths);
+        break;
+    }
+    std::sort(foundPaths.begin(), foundPaths.end());
+    return FsResult<std::vector<std::string>>::success(std::move(foundPaths));
+}
+
+FsResult<std::size_t> FileSystem::saveSnapshotTo(const std::string &path)
+{
+    VFS_TIME_OPERATION(StatOperation::Save);
+    return writeSnapshot(*rootDirectory, path);
+}
+
+FsResult<> FileSystem::loadSnapshotFrom(const std::string &path)
+{
+    VFS_TIME_OPERATION(StatOperation::Load);
+    FsResult<std::shared_ptr<Directory>> loaded = readSnapshot(path, *this);
+    if (!loaded.ok())
+    {
+        return FsResult<>::failure(loaded.status, std::move(loaded.detail));
+    }
+    bool contentIndexed = rootDirectory->getContext()->contentIndex != nullptr;
+    bool lockFreeReads = rootDirectory->hasLockFreeReads();
+    std::shared_ptr<TreeContext> context = std::make_shared<TreeContext>();
+    loaded.value->setContext(context);
+    for (auto &child : loaded.value->getChildren())
+    {
+        context->nameIndex.addSubtree(child.second.get());
+        context->timeIndex.addSubtree(child.second.get());
+    }
+    rootDirectory = std::move(loaded.value);
+    workingDirectory = rootDirectory;
+    pathResolver.clear();
+    if (contentIndexed)
+    {
+        setContentIndexEnabled(true);
+    }
+    if (lockFreeReads)
+    {
+        setLockFreeReads(true);
+    }
+    return FsResult<>::success({});
+}
+
+void FileSystem::saveSnapshot(const std::string &path)
+{
+    SinkFlushGuard flushOnReturn(*outputSink);
+    FsResult<std::size_t> saved = saveSnapshotTo(path);
+    if (!saved.ok())
+    {
+        *outputSink << "Cannot save snapshot: " << saved.detail << '\n';
+    }
+}
+
+void FileSystem::loadSnapshot(const std::string &path)
+{
+    SinkFlushGuard flushOnReturn(*outputSink);
+    FsResult<> loaded = loadSnapshotFrom(path);
+    if (!loaded.ok())
+    {
+        *outputSink << "Cannot load snapshot: " << loaded.detail << " (" << describeStatus(loaded.status) << ")\n";
+    }
+}
+
+void FileSystem::displayStats(const std::string &arguments)
+{
+    SinkFlushGuard flushOnReturn(*outputSink);
+    if (!Instrumentation::enabled)
+    {
+        *outputSink << "Instrumentation is compiled out" << '\n';
+        return;
+    }
+    std::string option;
+    std::istringstream(arguments) >> option;
+    if (option == "-reset")
+    {
+        Instrumentation::instance().reset();
+    }
+    else if (option == "-json")
+    {
+        *outputSink << Instrumentation::formatJson(Instrumentation::instance().snapshot()) << '\n';
+    }
     else
     {
-        std::cout << "Directory not found" << std::endl;
+        *outputSink << Instrumentation::formatTable(Instrumentation::instance().snapshot());
+    }
+}
+
+FsResult<MemoryReport> FileSystem::measureMemoryAt(const std::string &path)
+{
+    FsResult<Directory *> directory = resolveDirectory(path);
+    if (!directory.ok())
+    {
+        return FsResult<MemoryReport>::failure(directory.status, std::move(directory.detail));
+    }
+    return FsResult<MemoryReport>::success(measureMemory(*directory.value));
+}
+
+void FileSystem::displayMemoryUsage(const std::string &path)
+{
+    SinkFlushGuard flushOnReturn(*outputSink);
+    FsResult<MemoryReport> report = measureMemoryAt(path);
+    if (!report.ok())
+    {
+        *outputSink << "Directory not found: " << report.detail << '\n';
+        return;
+    }
+    *outputSink << formatMemoryReport(report.value);
+}
+
+static std::string generationPath(const std::string &directory, const char *kind, std::uint64_t generation)
+{
+    return directory + "/" + kind + "." + std::to_string(generation);
+}
+
+static bool parseGenerationName(const std::string &name, std::string &kind, std::uint64_t &generation)
+{
+    std::size_t dot = name.find('.');
+    if (dot == std::string::npos || dot + 1 == name.size() || name.size() - dot > 19 || name.find_first_not_of("0123456789", dot + 1) != std::string::npos)
+    {
+        return false;
     }
+    kind = name.substr(0, dot);
+    generation = std::stoull(name.substr(dot + 1));
+    return kind == "snapshot" || kind == "journal";
 }
 
-void FileSystem::removeFile(const std::string &fileName)
+static void removeGenerationsBefore(const std::string &directory, std::uint64_t oldestKept)
 {
-    auto files = workingDirectory->getSubDirectories();
-    if (fileName.find("*.") != std::string::npos)
+    std::error_code error;
+    std::vector<std::filesystem::path> stale;
+    for (const auto &entry : std::filesystem::directory_iterator(directory, error))
     {
-        std::string extension = fileName;
-        extension = extension.substr(1);
-        for (auto &file : files)
+        std::string kind;
+        std::uint64_t generation;
+        if (parseGenerationName(entry.path().filename().string(), kind, generation) && generation < oldestKept)
         {
+            stale.push_back(entry.path());
+        }
+    }
+    for (auto &path : stale)
+    {
+        std::filesystem::remove(path, error);
+    }
+}
 
-            if (file.second->getComponentType() == "File" && ((file.first).find(extension) != std::string::npos))
-            {
-                workingDirectory->removeChild(file.first);
-            }
+FsResult<std::size_t> FileSystem::openJournal(const std::string &directory, const JournalOptions &options)
+{
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    std::uint64_t snapshotGeneration = 0;
+    bool hasSnapshot = false;
+    std::vector<std::uint64_t> journalGenerations;
+    for (const auto &entry : std::filesystem::directory_iterator(directory, error))
+    {
+        std::string kind;
+        std::uint64_t generation;
+        if (!parseGenerationName(entry.path().filename().string(), kind, generation))
+        {
+            continue;
+        }
+        if (kind == "snapshot" && (!hasSnapshot || generation > snapshotGeneration))
+        {
+            snapshotGeneration = generation;
+            hasSnapshot = true;
+        }
+        else if (kind == "journal")
+        {
+            journalGenerations.push_back(generation);
         }
     }
-    else
+    if (error)
+    {
+        return FsResult<std::size_t>::failure(FsStatus::IoError, directory);
+    }
+    if (hasSnapshot)
     {
-        auto findFile = files.find(fileName);
-        if (findFile != files.end() && (findFile->second)->getComponentType() == "File")
+        FsResult<> loaded = loadSnapshotFrom(generationPath(directory, "snapshot", snapshotGeneration));
+        if (!loaded.ok())
         {
-            auto file = std::dynamic_pointer_cast<File>(findFile->second);
-            workingDirectory->removeChild(fileName);
+            return FsResult<std::size_t>::failure(loaded.status, std::move(loaded.detail));
         }
-        else
+    }
+
+    journal.reset();
+    std::sort(journalGenerations.begin(), journalGenerations.end());
+    std::uint64_t latestGeneration = snapshotGeneration;
+    std::size_t replayed = 0;
+    for (std::uint64_t generation : journalGenerations)
+    {
+        std::string path = generationPath(directory, "journal", generation);
+        if (generation < snapshotGeneration)
+        {
+            continue;
+        }
+        FsResult<std::size_t> replayedRecords = Journal::replay(path, [this](const JournalRecord &record)
+                                                                { applyJournalRecord(record); });
+        if (!replayedRecords.ok())
         {
-            std::cout << "File not found" << std::endl;
+            return replayedRecords;
         }
+        replayed += replayedRecords.value;
+        latestGeneration = generation;
     }
+    FsResult<std::unique_ptr<Journal>> opened = Journal::open(generationPath(directory, "journal", latestGeneration), options);
+    if (!opened.ok())
+    {
+        return FsResult<std::size_t>::failure(opened.status, std::move(opened.detail));
+    }
+    removeGenerationsBefore(directory, snapshotGeneration);
+    journal = std::move(opened.value);
+    journalDirectory = directory;
+    journalGeneration = latestGeneration;
+    journalOptions = options;
+    workingDirectory = rootDirectory;
+    return FsResult<std::size_t>::success(replayed);
 }
 
-void FileSystem::fileFound(const std::string &fileName, const std::pair<std::string, std::shared_ptr<FileSystemComponent>> &fileComponent, std::string currentPath)
+FsResult<> FileSystem::compactJournal()
 {
-    if (fileComponent.second->getComponentType() == "File" && fileComponent.first == fileName)
+    if (journal == nullptr)
     {
-        std::cout << currentPath << "/" << fileComponent.first << std::endl;
-        return;
+        return FsResult<>::failure(FsStatus::InvalidArgument, "journal");
+    }
+    if (!journal->sync())
+    {
+        return FsResult<>::failure(FsStatus::IoError, "journal");
+    }
+    std::uint64_t nextGeneration = journalGeneration + 1;
+    FsResult<std::unique_ptr<Journal>> nextJournal = Journal::open(generationPath(journalDirectory, "journal", nextGeneration), journalOptions);
+    if (!nextJournal.ok())
+    {
+        return FsResult<>::failure(nextJournal.status, std::move(nextJournal.detail));
     }
-    else if (fileComponent.second->getComponentType() == "Directory")
+    journal = std::move(nextJournal.value);
+    journalGeneration = nextGeneration;
+    std::string snapshotPath = generationPath(journalDirectory, "snapshot", nextGeneration);
+    FsResult<std::size_t> saved = saveSnapshotTo(snapshotPath);
+    if (!saved.ok())
     {
-        std::shared_ptr<Directory> directory = std::dynamic_pointer_cast<Directory>(fileComponent.second);
-        auto files = directory->getSubDirectories();
-        for (auto &file : files)
+        return FsResult<>::failure(saved.status, std::move(saved.detail));
+    }
+    // The older generations are the only copy of the tree until the new snapshot is known to load back.
+    FileSystem scratch;
+    FsResult<std::shared_ptr<Directory>> verified = readSnapshot(snapshotPath, scratch);
+    if (!verified.ok())
+    {
+        std::remove(snapshotPath.c_str());
+        return FsResult<>::failure(verified.status, std::move(verified.detail));
+    }
+    if (!syncToDisk(journalDirectory))
+    {
+        return FsResult<>::failure(FsStatus::IoError, journalDirectory);
+    }
+    removeGenerationsBefore(journalDirectory, nextGeneration);
+    return FsResult<>::success({});
+}
+
+bool FileSystem::journalOperation(JournalOperation operation, const std::string &path, Timestamp time, const std::string &text)
+{
+    if (!journal->append(JournalRecord{operation, time, path, text}))
+    {
+        return false;
+    }
+    if (journalOptions.compactionThreshold != 0 && journal->size() >= journalOptions.compactionThreshold)
+    {
+        FsResult<> compacted = compactJournal();
+        if (!compacted.ok())
         {
-            std::string updatedPath = currentPath + "/" + directory->getName();
-            fileFound(fileName, std::make_pair(file.first, file.second), updatedPath);
+            *outputSink << "Cannot compact journal: " << compacted.detail << " (" << describeStatus(compacted.status) << ")\n";
         }
     }
+    return true;
 }
 
-void FileSystem::findByTime(const int &range, const std::pair<std::string, std::shared_ptr<FileSystemComponent>> &fileComponent, std::string currentPath)
+void FileSystem::applyJournalRecord(const JournalRecord &record)
+{
+    switch (record.operation)
+    {
+    case JournalOperation::CreateDirectory:
+        createDirectories(record.path);
+        break;
+    case JournalOperation::CreateFile:
+        if (FsResult<File *> created = createFileAt(record.path); created.ok())
+        {
+            restoreFileTimes(created.value, record.time, record.time);
+        }
+        break;
+    case JournalOperation::Append:
+        if (FsResult<File *> appended = appendToFile(record.path, record.text); appended.ok())
+        {
+            restoreFileTimes(appended.value, appended.value->getCreationTime(), record.time);
+        }
+        break;
+    case JournalOperation::RemoveFiles:
+        deleteFiles(record.path);
+        break;
+    case JournalOperation::RemoveDirectory:
+        deleteDirectory(record.path);
+        break;
+    case JournalOperation::RemoveDirectoryTree:
+        deleteDirectory(record.path, true);
+        break;
+    case JournalOperation::RemoveFilesRecursive:
+        deleteFiles(record.path, true);
+        break;
+    }
+}
+
+void FileSystem::restoreFileTimes(File *file, Timestamp created, Timestamp modified)
+{
+    TreeContext *context = rootDirectory->getContext();
+    std::unique_lock<std::shared_mutex> indexLock(context->indexMutex);
+    context->timeIndex.update(file, file->getModificationTime(), modified);
+    file->restoreTimes(created, modified);
+}
+
+void FileSystem::appendPath(std::string &currentPath, std::string_view name)
 {
-    std::time_t timestamp = (fileComponent.second)->getTimestamp();
-    auto currentTimestamp = std::chrono::system_clock::now();
-    auto fileTimestamp = std::chrono::system_clock::from_time_t(timestamp);
+    if (!currentPath.empty())
+    {
+        currentPath += '/';
+    }
+    currentPath += name;
+}
+
+void FileSystem::setFindThreadCount(std::size_t threadCount)
+{
+    if (threadCount <= 1)
+    {
+        findPool.reset();
+    }
+    else if (findPool == nullptr || findPool->getThreadCount() != threadCount)
+    {
+        findPool = std::make_unique<WorkStealingPool>(threadCount);
+    }
+}
 
-    if (fileComponent.second->getComponentType() == "File")
+void FileSystem::setContentIndexEnabled(bool enabled)
+{
+    TreeContext *context = rootDirectory->getContext();
+    if (!enabled)
+    {
+        std::unique_lock<std::shared_mutex> indexLock(context->indexMutex);
+        context->contentIndex.reset();
+    }
+    else if (context->contentIndex == nullptr)
     {
-        auto difference = std::chrono::duration_cast<std::chrono::seconds>(currentTimestamp - fileTimestamp);
-        int differenceInSeconds = difference.count();
-        if (differenceInSeconds <= range)
+        std::unique_lock<std::shared_mutex> indexLock(context->indexMutex);
+        context->contentIndex = std::make_unique<ContentIndex>();
+        context->contentIndex->addSubtree(rootDirectory.get());
+    }
+}
+
+bool FileSystem::findWithContentIndex(const ContentMatcher &matcher, const Directory &directory, const std::string &currentPath, std::vector<std::string> &foundPaths)
+{
+    TreeContext *context = directory.getContext();
+    if (context == nullptr)
+    {
+        return false;
+    }
+    std::shared_lock<std::shared_mutex> indexLock(context->indexMutex);
+    if (context->contentIndex == nullptr)
+    {
+        return false;
+    }
+    for (auto &pattern : matcher.getPatterns())
+    {
+        if (!context->contentIndex->canNarrow(pattern))
         {
-            std::cout << currentPath << "/" << fileComponent.first << std::endl;
-            return;
+            return false;
         }
     }
-    else if (fileComponent.second->getComponentType() == "Directory")
+    std::vector<File *> candidates;
+    for (auto &pattern : matcher.getPatterns())
+    {
+        std::vector<File *> patternCandidates = context->contentIndex->findCandidates(pattern);
+        candidates.insert(candidates.end(), patternCandidates.begin(), patternCandidates.end());
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    VFS_STATS(Instrumentation::addFindVisits(candidates.size()));
+    std::string path;
+    for (File *file : candidates)
     {
-        std::shared_ptr<Directory> directory = std::dynamic_pointer_cast<Directory>(fileComponent.second);
-        auto files = directory->getSubDirectories();
-        for (auto &file : files)
+        if (pathUnderDirectory(file, directory, currentPath, path) && contentMatches(matcher, *file))
         {
-            std::string updatedPath = currentPath + "/" + directory->getName();
-            findByTime(range, std::make_pair(file.first, file.second), updatedPath);
+            foundPaths.push_back(path);
         }
     }
+    return true;
 }
 
-void FileSystem::findByContent(const std::string &content, const std::pair<std::string, std::shared_ptr<FileSystemComponent>> &fileComponent, std::string currentPath)
+bool FileSystem::findWithNameIndex(const std::string &fileName, const Directory &directory, const std::string &currentPath, std::vector<std::string> &foundPaths)
 {
-    if (fileComponent.second->getComponentType() == "File")
+    TreeContext *context = directory.getContext();
+    if (context == nullptr)
+    {
+        return false;
+    }
+    std::shared_lock<std::shared_mutex> indexLock(context->indexMutex);
+    const std::unordered_set<File *> *files = context->nameIndex.find(fileName);
+    if (files == nullptr)
+    {
+        return true;
+    }
+    VFS_STATS(Instrumentation::addFindVisits(files->size()));
+    std::string path;
+    for (File *file : *files)
     {
-        std::shared_ptr<File> file = std::dynamic_pointer_cast<File>(fileComponent.second);
-        if ((file->getContent()).find(content) != std::string::npos)
+        if (pathUnderDirectory(file, directory, currentPath, path))
         {
-            std::cout << currentPath << "/" << fileComponent.first << std::endl;
-            return;
+            foundPaths.push_back(path);
         }
     }
-    else if (fileComponent.second->getComponentType() == "Directory")
+    return true;
+}
+
+void FileSystem::collectByGlob(const GlobPattern &pattern, const Directory &directory, const std::string &currentPath, std::vector<std::string> &foundPaths)
+{
+    TreeContext *context = directory.getContext();
+    if (context != nullptr && !pattern.matchesAcrossSegments())
     {
-        std::shared_ptr<Directory> directory = std::dynamic_pointer_cast<Directory>(fileComponent.second);
-        auto files = directory->getSubDirectories();
-        for (auto &file : files)
+        std::shared_lock<std::shared_mutex> indexLock(context->indexMutex);
+        std::string path;
+        context->nameIndex.forEachName([&](std::string_view name, const std::unordered_set<File *> &files)
+                                       {
+            VFS_STATS(Instrumentation::addFindVisits(1));
+            if (!pattern.matches(name))
+            {
+                return;
+            }
+            VFS_STATS(Instrumentation::addFindVisits(files.size()));
+            for (File *file : files)
+            {
+                if (pathUnderDirectory(file, directory, currentPath, path))
+                {
+                    foundPaths.push_back(path);
+                }
+            } });
+    }
+    else
+    {
+        std::string path = currentPath;
+        walkByGlob(pattern, directory, path, currentPath.size() + 1, foundPaths);
+    }
+}
+
+void FileSystem::walkByGlob(const GlobPattern &pattern, const Directory &directory, std::string &currentPath, std::size_t relativeStart, std::vector<std::string> &foundPaths)
+{
+    std::shared_lock<std::shared_mutex> directoryLock(directory.getMutex());
+    VFS_STATS(Instrumentation::addFindVisits(directory.getChildren().size()));
+    for (auto &file : directory.getChildren())
+    {
+        std::size_t pathLength = currentPath.size();
+        appendPath(currentPath, file.first);
+        std::string_view relativePath = std::string_view(currentPath).substr(std::min(relativeStart, currentPath.size()));
+        if (file.second->isFile())
+        {
+            if (pattern.matches(pattern.matchesAcrossSegments() ? relativePath : std::string_view(file.first)))
+            {
+                foundPaths.push_back(currentPath);
+            }
+        }
+        else if (file.second->isDirectory())
         {
-            std::string updatedPath = currentPath + "/" + directory->getName();
-            findByContent(content, std::make_pair(file.first, file.second), updatedPath);
+            walkByGlob(pattern, static_cast<const Directory &>(*file.second), currentPath, relativeStart, foundPaths);
         }
+        currentPath.resize(pathLength);
+    }
+}
+
+bool FileSystem::findWithTimeIndex(Timestamp cutoff, const Directory &directory, const std::string &currentPath, std::vector<std::string> &foundPaths)
+{
+    TreeContext *context = directory.getContext();
+    if (context == nullptr)
+    {
+        return false;
+    }
+    std::shared_lock<std::shared_mutex> indexLock(context->indexMutex);
+    std::string path;
+    context->timeIndex.forEachModifiedSince(cutoff, [&](File *file)
+                                            {
+        VFS_STATS(Instrumentation::addFindVisits(1));
+        if (pathUnderDirectory(file, directory, currentPath, path))
+        {
+            foundPaths.push_back(path);
+        } });
+    return true;
+}
+
+bool FileSystem::contentMatches(const ContentMatcher &matcher, const File &file)
+{
+    std::shared_lock<std::shared_mutex> contentLock(TreeContext::contentMutexFor(&file));
+    return matcher.matches(file.getFileContent());
+}
+
+// File::setContent stamps the modification time under the same stripe lock as the content.
+bool FileSystem::modifiedSince(Timestamp cutoff, const FileSystemComponent &file)
+{
+    std::shared_lock<std::shared_mutex> contentLock(TreeContext::contentMutexFor(static_cast<const File *>(&file)));
+    return file.getModificationTime() >= cutoff;
+}
+
+bool FileSystem::pathUnderDirectory(FileSystemComponent *component, const Directory &directory, const std::string &currentPath, std::string &path)
+{
+    std::vector<FileSystemComponent *> ancestors{component};
+    Directory *ancestor = component->getParent();
+    while (ancestor != nullptr && ancestor != &directory)
+    {
+        ancestors.push_back(ancestor);
+        ancestor = ancestor->getParent();
+    }
+    if (ancestor == nullptr)
+    {
+        return false;
+    }
+    path = currentPath;
+    for (auto eachComponent = ancestors.rbegin(); eachComponent != ancestors.rend(); ++eachComponent)
+    {
+        path += '/';
+        path += (*eachComponent)->getNameView();
+    }
+    return true;
+}
+
+void FileSystem::printSortedPaths(std::vector<std::string> &paths)
+{
+    std::sort(paths.begin(), paths.end());
+    for (auto &path : paths)
+    {
+        *outputSink << path << '\n';
+    }
+}
+
+bool FileSystem::findInParallel(const Directory &directory, const std::string &currentPath, const FileMatcher &matches, std::vector<std::string> &mergedPaths)
+{
+    if (findPool == nullptr)
+    {
+        return false;
     }
+    std::vector<std::vector<std::string>> foundPaths(findPool->getThreadCount());
+    std::atomic<std::size_t> visitedNodes{0};
+    scanInParallel(directory, currentPath, matches, foundPaths, visitedNodes);
+    findPool->wait();
+    VFS_STATS(Instrumentation::addFindVisits(visitedNodes.load(std::memory_order_relaxed)));
+    for (auto &workerPaths : foundPaths)
+    {
+        mergedPaths.insert(mergedPaths.end(), std::make_move_iterator(workerPaths.begin()), std::make_move_iterator(workerPaths.end()));
+    }
+    return true;
+}
+
+void FileSystem::scanInParallel(const Directory &directory, std::string currentPath, const FileMatcher &matches, std::vector<std::vector<std::string>> &foundPaths, std::atomic<std::size_t> &visitedNodes)
+{
+    findPool->submit([this, directory = directory.shared_from_this(), currentPath = std::move(currentPath), &matches, &foundPaths, &visitedNodes]()
+                     {
+        std::vector<std::string> &workerPaths = foundPaths[WorkStealingPool::currentWorker()];
+        std::shared_lock<std::shared_mutex> directoryLock(directory->getMutex());
+        VFS_STATS(visitedNodes.fetch_add(directory->getChildren().size(), std::memory_order_relaxed));
+        for (auto &file : directory->getChildren())
+        {
+            if (file.second->isFile())
+            {
+                if (matches(file.first, *file.second))
+                {
+                    workerPaths.push_back(currentPath + "/" + file.first);
+                }
+            }
+            else
+            {
+                scanInParallel(static_cast<const Directory &>(*file.second), currentPath + "/" + file.first, matches, foundPaths, visitedNodes);
+            }
+        } });
 }
 
 void FileSystem::findFile(const std::string &arguments)
 {
+    VFS_TIME_OPERATION(StatOperation::Find);
+    SinkFlushGuard flushOnReturn(*outputSink);
     std::string path;
     std::string argument;
     std::string option;
     std::istringstream argumentStream(arguments);
     argumentStream >> option;
+    if (option == "-j")
+    {
+        std::size_t threadCount = 1;
+        argumentStream >> threadCount;
+        setFindThreadCount(threadCount);
+        argumentStream >> option;
+    }
     argumentStream >> path;
     if (argumentStream.peek() != EOF)
     {
@@ -391,31 +1307,34 @@ void FileSystem::findFile(const std::string &arguments)
         argument = path;
         path = " ";
     }
-    if (path != " ")
+    FsResult<Directory *> foundDirectory = resolveDirectory(path);
+    Directory *startDirectory = foundDirectory.ok() ? foundDirectory.value : workingDirectory.get();
+    if (!foundDirectory.ok())
     {
-        changeDirectory(path);
+        *outputSink << "Directory not found: " << foundDirectory.detail << '\n';
     }
-    auto files = workingDirectory->getSubDirectories();
+    std::string parentPath;
+    std::string directoryName = getPathOf(startDirectory);
+    std::size_t separator = directoryName.rfind('/');
+    if (separator != std::string::npos)
+    {
+        parentPath = directoryName.substr(0, separator);
+        directoryName = directoryName.substr(separator + 1);
+    }
+    auto startComponent = std::make_pair(directoryName, std::static_pointer_cast<FileSystemComponent>(startDirectory->shared_from_this()));
     if (option == "-file")
     {
-        for (auto &file : files)
-        {
-            fileFound(argument, std::make_pair(file.first, file.second), pathOfWorkingDirectory);
-        }
+        fileFound(argument, startComponent, parentPath);
     }
     else if (option == "-time")
     {
-        for (auto &file : files)
-        {
-            int range = std::stoi(argument);
-            findByTime(range, std::make_pair(file.first, file.second), pathOfWorkingDirectory);
-        }
+        int range = std::stoi(argument);
+        findByTime(range, startComponent, parentPath);
     }
-    else if (option == "-content")
+    else if (option == "-content" || option == "-icontent")
     {
-        for (auto &file : files)
-        {
-            findByContent(argument, std::make_pair(file.first, file.second), pathOfWorkingDirectory);
-        }
+        ignoreContentCase = option == "-icontent";
+        findByContent(argument, startComponent, parentPath);
+        ignoreContentCase = false;
     }
 }
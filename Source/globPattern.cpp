@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <bit>
+#include <iterator>
+
+#include "globPattern.hpp"
+
+GlobPattern::GlobPattern(std::string_view text) : pattern(text)
+{
+    for (std::size_t position = 0; position < pattern.size(); ++position)
+    {
+        char character = pattern[position];
+        if (character == '*')
+        {
+            literal = false;
+            if (position + 1 < pattern.size() && pattern[position + 1] == '*')
+            {
+                ++position;
+                if (position + 1 < pattern.size() && pattern[position + 1] == '/')
+                {
+                    ++position;
+                    tokens.push_back({TokenKind::DirectoryPrefix});
+                }
+                else
+                {
+                    tokens.push_back({TokenKind::DoubleStar});
+                }
+            }
+            else
+            {
+                tokens.push_back({TokenKind::Star});
+            }
+        }
+        else if (character == '?')
+        {
+            literal = false;
+            tokens.push_back({TokenKind::AnyCharacter});
+        }
+        else if (character == '[' && pattern.find(']', position + 2) != std::string::npos)
+        {
+            literal = false;
+            position = parseCharacterClass(position);
+        }
+        else
+        {
+            if (character == '\\' && position + 1 < pattern.size())
+            {
+                character = pattern[++position];
+            }
+            tokens.push_back({TokenKind::Character, character});
+            unescaped.push_back(character);
+        }
+    }
+
+    for (std::size_t index = 0; index < tokens.size() && tokens[index].kind == TokenKind::Character; ++index)
+    {
+        literalPrefix.push_back(tokens[index].character);
+    }
+    suffixOnly = !tokens.empty() && tokens.front().kind == TokenKind::Star;
+    for (std::size_t index = 1; suffixOnly && index < tokens.size(); ++index)
+    {
+        suffixOnly = tokens[index].kind == TokenKind::Character;
+        literalSuffix.push_back(tokens[index].character);
+    }
+    if (!suffixOnly)
+    {
+        literalSuffix.clear();
+    }
+}
+
+std::size_t GlobPattern::parseCharacterClass(std::size_t position)
+{
+    std::bitset<256> members;
+    bool negated = false;
+    ++position;
+    if (pattern[position] == '!' || pattern[position] == '^')
+    {
+        negated = true;
+        ++position;
+    }
+    std::size_t first = position;
+    for (; position < pattern.size() && (pattern[position] != ']' || position == first); ++position)
+    {
+        auto low = static_cast<unsigned char>(pattern[position]);
+        if (position + 2 < pattern.size() && pattern[position + 1] == '-' && pattern[position + 2] != ']')
+        {
+            auto high = static_cast<unsigned char>(pattern[position + 2]);
+            for (unsigned member = low; member <= high; ++member)
+            {
+                members.set(member);
+            }
+            position += 2;
+        }
+        else
+        {
+            members.set(low);
+        }
+    }
+    if (negated)
+    {
+        members.flip();
+    }
+    members.reset('/');
+    tokens.push_back({TokenKind::CharacterClass, 0, static_cast<std::uint32_t>(characterClasses.size())});
+    characterClasses.push_back(members);
+    return position;
+}
+
+bool GlobPattern::hasWildcards(std::string_view text)
+{
+    return text.find_first_of("*?[") != std::string_view::npos;
+}
+
+void GlobPattern::addClosure(std::uint64_t *states, bool atSegmentStart) const
+{
+    for (std::size_t index = 0; index < tokens.size(); ++index)
+    {
+        TokenKind kind = tokens[index].kind;
+        bool skippable = kind == TokenKind::Star || kind == TokenKind::DoubleStar || (kind == TokenKind::DirectoryPrefix && atSegmentStart);
+        if (skippable && (states[index / 64] >> (index % 64) & 1))
+        {
+            states[(index + 1) / 64] |= std::uint64_t{1} << ((index + 1) % 64);
+        }
+    }
+}
+
+bool GlobPattern::matches(std::string_view text) const
+{
+    if (literal)
+    {
+        return text == unescaped;
+    }
+    if (suffixOnly)
+    {
+        return text.size() >= literalSuffix.size() && text.find('/') == std::string_view::npos &&
+               text.compare(text.size() - literalSuffix.size(), literalSuffix.size(), literalSuffix) == 0;
+    }
+
+    const std::size_t wordCount = tokens.size() / 64 + 1;
+    std::uint64_t inlineWords[8] = {};
+    std::vector<std::uint64_t> heapWords;
+    std::uint64_t *current = inlineWords;
+    if (wordCount * 2 > std::size(inlineWords))
+    {
+        heapWords.assign(wordCount * 2, 0);
+        current = heapWords.data();
+    }
+    std::uint64_t *next = current + wordCount;
+    auto setState = [](std::uint64_t *states, std::size_t index)
+    { states[index / 64] |= std::uint64_t{1} << (index % 64); };
+
+    setState(current, 0);
+    addClosure(current, true);
+    for (char character : text)
+    {
+        std::fill(next, next + wordCount, 0);
+        for (std::size_t word = 0; word < wordCount; ++word)
+        {
+            for (std::uint64_t bits = current[word]; bits != 0; bits &= bits - 1)
+            {
+                std::size_t index = word * 64 + std::countr_zero(bits);
+                if (index == tokens.size())
+                {
+                    continue;
+                }
+                const Token &token = tokens[index];
+                switch (token.kind)
+                {
+                case TokenKind::Character:
+                    if (character == token.character)
+                    {
+                        setState(next, index + 1);
+                    }
+                    break;
+                case TokenKind::AnyCharacter:
+                    if (character != '/')
+                    {
+                        setState(next, index + 1);
+                    }
+                    break;
+                case TokenKind::CharacterClass:
+                    if (characterClasses[token.characterClass].test(static_cast<unsigned char>(character)))
+                    {
+                        setState(next, index + 1);
+                    }
+                    break;
+                case TokenKind::Star:
+                    if (character != '/')
+                    {
+                        setState(next, index);
+                    }
+                    break;
+                case TokenKind::DoubleStar:
+                    setState(next, index);
+                    break;
+                case TokenKind::DirectoryPrefix:
+                    setState(next, index);
+                    if (character == '/')
+                    {
+                        setState(next, index + 1);
+                    }
+                    break;
+                }
+            }
+        }
+        addClosure(next, character == '/');
+        if (std::all_of(next, next + wordCount, [](std::uint64_t bits)
+                        { return bits == 0; }))
+        {
+            return false;
+        }
+        std::swap(current, next);
+    }
+    return current[tokens.size() / 64] >> (tokens.size() % 64) & 1;
+}
\ No newline at end of file
@@ -0,0 +1,384 @@
+#include <algorithm>
+#include <bit>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#include "instrumentation.hpp"
+
+static constexpr const char *operationNames[] = {"createDirectory", "changeDirectory", "createFile", "append", "read", "list", "removeDirectory", "removeFiles", "find", "save", "load"};
+static constexpr const char *counterNames[] = {"bytesAppended", "pathCacheHits", "nodeAllocations", "slabAllocations", "chunkAllocations"};
+
+// Each histogram has a single writer, so a relaxed load and store is enough and avoids a locked add.
+static void bump(std::atomic<std::uint64_t> &value, std::uint64_t amount)
+{
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+std::size_t LatencyHistogram::bucketFor(std::uint64_t value)
+{
+    if (value < (1u << subBucketBits))
+    {
+        return static_cast<std::size_t>(value);
+    }
+    unsigned shift = static_cast<unsigned>(std::bit_width(value)) - 1 - subBucketBits;
+    return ((shift + 1) << subBucketBits) + ((value >> shift) & ((1u << subBucketBits) - 1));
+}
+
+std::uint64_t LatencyHistogram::bucketUpperBound(std::size_t bucket)
+{
+    if (bucket < (1u << subBucketBits))
+    {
+        return bucket;
+    }
+    unsigned shift = static_cast<unsigned>(bucket >> subBucketBits) - 1;
+    std::uint64_t lowerBound = static_cast<std::uint64_t>((bucket & ((1u << subBucketBits) - 1)) | (1u << subBucketBits)) << shift;
+    return lowerBound + ((std::uint64_t{1} << shift) - 1);
+}
+
+void LatencyHistogram::record(std::uint64_t value)
+{
+    bump(buckets[bucketFor(value)], 1);
+    bump(count, 1);
+    bump(sum, value);
+    if (value > maximum.load(std::memory_order_relaxed))
+    {
+        maximum.store(value, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::clear()
+{
+    for (auto &bucket : buckets)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    maximum.store(0, std::memory_order_relaxed);
+}
+
+struct MergedHistogram
+{
+    std::array<std::uint64_t, LatencyHistogram::bucketCount> buckets{};
+    HistogramSummary summary;
+
+    void add(const LatencyHistogram &histogram)
+    {
+        for (std::size_t bucket = 0; bucket < buckets.size(); ++bucket)
+        {
+            buckets[bucket] += histogram.buckets[bucket].load(std::memory_order_relaxed);
+        }
+        summary.samples += histogram.count.load(std::memory_order_relaxed);
+        summary.sum += histogram.sum.load(std::memory_order_relaxed);
+        summary.maximum = std::max(summary.maximum, histogram.maximum.load(std::memory_order_relaxed));
+    }
+
+    std::uint64_t percentile(std::uint64_t total, std::uint64_t perMille) const
+    {
+        std::uint64_t rank = (total * perMille + 999) / 1000;
+        std::uint64_t seen = 0;
+        for (std::size_t bucket = 0; bucket < buckets.size(); ++bucket)
+        {
+            seen += buckets[bucket];
+            if (seen >= rank && seen != 0)
+            {
+                return std::min(LatencyHistogram::bucketUpperBound(bucket), summary.maximum);
+            }
+        }
+        return summary.maximum;
+    }
+
+    HistogramSummary finish(double scale = 1.0)
+    {
+        std::uint64_t total = 0;
+        for (std::uint64_t bucket : buckets)
+        {
+            total += bucket;
+        }
+        summary.count = summary.samples;
+        summary.p50 = percentile(total, 500);
+        summary.p99 = percentile(total, 990);
+        summary.p999 = percentile(total, 999);
+        if (scale != 1.0)
+        {
+            for (std::uint64_t *value : {&summary.sum, &summary.maximum, &summary.p50, &summary.p99, &summary.p999})
+            {
+                *value = static_cast<std::uint64_t>(static_cast<double>(*value) * scale);
+            }
+        }
+        return summary;
+    }
+};
+
+struct ThreadStatsHandle
+{
+    Instrumentation::ThreadStats *stats = nullptr;
+
+    ~ThreadStatsHandle()
+    {
+        if (stats != nullptr)
+        {
+            stats->inUse.store(false, std::memory_order_release);
+        }
+    }
+};
+
+static thread_local ThreadStatsHandle threadStats;
+
+// Reading the clock costs more than a cached directory lookup, so by default one operation in 16 is timed.
+std::atomic<std::uint32_t> Instrumentation::samplingInterval{16};
+std::atomic<std::uint64_t> Instrumentation::resetGeneration{0};
+
+Instrumentation &Instrumentation::instance()
+{
+    static Instrumentation instrumentation;
+    return instrumentation;
+}
+
+Instrumentation::Instrumentation() : calibrationTicks(ticks()), calibrationTime(std::chrono::steady_clock::now())
+{
+}
+
+double Instrumentation::nanosecondsPerTick()
+{
+#ifdef VFS_TSC_CLOCK
+    while (std::chrono::steady_clock::now() - calibrationTime < std::chrono::milliseconds(5))
+    {
+        std::this_thread::yield();
+    }
+    std::uint64_t elapsedTicks = ticks() - calibrationTicks;
+    std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - calibrationTime;
+    return static_cast<double>(elapsed.count()) / static_cast<double>(elapsedTicks);
+#else
+    return 1.0;
+#endif
+}
+
+Instrumentation::~Instrumentation()
+{
+    ThreadStats *stats = threads.load();
+    while (stats != nullptr)
+    {
+        ThreadStats *next = stats->next;
+        delete stats;
+        stats = next;
+    }
+}
+
+Instrumentation::ThreadStats *Instrumentation::acquireStats()
+{
+    for (ThreadStats *stats = threads.load(); stats != nullptr; stats = stats->next)
+    {
+        bool expected = false;
+        if (!stats->inUse.load(std::memory_order_relaxed) && stats->inUse.compare_exchange_strong(expected, true))
+        {
+            return stats;
+        }
+    }
+    ThreadStats *stats = new ThreadStats;
+    stats->inUse.store(true, std::memory_order_relaxed);
+    stats->next = threads.load();
+    while (!threads.compare_exchange_weak(stats->next, stats))
+    {
+    }
+    return stats;
+}
+
+void Instrumentation::clear(ThreadStats &stats)
+{
+    for (LatencyHistogram &histogram : stats.operations)
+    {
+        histogram.clear();
+    }
+    for (auto &operationCount : stats.operationCounts)
+    {
+        operationCount.store(0, std::memory_order_relaxed);
+    }
+    stats.pathDepth.clear();
+    stats.findVisits.clear();
+    for (auto &counter : stats.counters)
+    {
+        counter.store(0, std::memory_order_relaxed);
+    }
+}
+
+// A reset only bumps the generation; each owner clears its own stats the next time it records, so every slot keeps a single writer.
+Instrumentation::ThreadStats &Instrumentation::local()
+{
+    if (threadStats.stats == nullptr)
+    {
+        threadStats.stats = instance().acquireStats();
+    }
+    ThreadStats &stats = *threadStats.stats;
+    std::uint64_t generation = resetGeneration.load(std::memory_order_acquire);
+    if (stats.appliedReset.load(std::memory_order_relaxed) != generation)
+    {
+        clear(stats);
+        stats.appliedReset.store(generation, std::memory_order_release);
+    }
+    return stats;
+}
+
+bool Instrumentation::sampleOperation()
+{
+    ThreadStats &stats = local();
+    if (++stats.sinceLastSample < samplingInterval.load(std::memory_order_relaxed))
+    {
+        return false;
+    }
+    stats.sinceLastSample = 0;
+    return true;
+}
+
+void Instrumentation::recordOperation(StatOperation operation, bool sampled, std::uint64_t elapsedTicks)
+{
+    ThreadStats &stats = local();
+    bump(stats.operationCounts[static_cast<std::size_t>(operation)], 1);
+    if (sampled)
+    {
+        stats.operations[static_cast<std::size_t>(operation)].record(elapsedTicks);
+    }
+}
+
+void Instrumentation::recordPathDepth(std::size_t depth)
+{
+    local().pathDepth.record(depth);
+}
+
+void Instrumentation::addFindVisits(std::size_t visits)
+{
+    local().pendingFindVisits += visits;
+}
+
+void Instrumentation::finishFind()
+{
+    ThreadStats &stats = local();
+    stats.findVisits.record(stats.pendingFindVisits);
+    stats.pendingFindVisits = 0;
+}
+
+void Instrumentation::count(StatCounter counter, std::uint64_t amount)
+{
+    bump(local().counters[static_cast<std::size_t>(counter)], amount);
+}
+
+StatsSnapshot Instrumentation::snapshot()
+{
+    std::array<MergedHistogram, static_cast<std::size_t>(StatOperation::Count)> operations;
+    std::array<std::uint64_t, static_cast<std::size_t>(StatOperation::Count)> operationCounts{};
+    MergedHistogram pathDepth;
+    MergedHistogram findVisits;
+    StatsSnapshot stats;
+    std::uint64_t generation = resetGeneration.load(std::memory_order_acquire);
+    for (ThreadStats *thread = threads.load(std::memory_order_acquire); thread != nullptr; thread = thread->next)
+    {
+        if (thread->appliedReset.load(std::memory_order_acquire) != generation)
+        {
+            continue;
+        }
+        for (std::size_t operation = 0; operation < operations.size(); ++operation)
+        {
+            operations[operation].add(thread->operations[operation]);
+            operationCounts[operation] += thread->operationCounts[operation].load(std::memory_order_relaxed);
+        }
+        pathDepth.add(thread->pathDepth);
+        findVisits.add(thread->findVisits);
+        for (std::size_t counter = 0; counter < stats.counters.size(); ++counter)
+        {
+            stats.counters[counter] += thread->counters[counter].load(std::memory_order_relaxed);
+        }
+    }
+    double scale = nanosecondsPerTick();
+    for (std::size_t operation = 0; operation < operations.size(); ++operation)
+    {
+        stats.operations[operation] = operations[operation].finish(scale);
+        stats.operations[operation].count = operationCounts[operation];
+    }
+    stats.pathDepth = pathDepth.finish();
+    stats.findVisits = findVisits.finish();
+    return stats;
+}
+
+void Instrumentation::reset()
+{
+    resetGeneration.fetch_add(1, std::memory_order_acq_rel);
+}
+
+const char *Instrumentation::operationName(StatOperation operation)
+{
+    return operationNames[static_cast<std::size_t>(operation)];
+}
+
+const char *Instrumentation::counterName(StatCounter counter)
+{
+    return counterNames[static_cast<std::size_t>(counter)];
+}
+
+static double microseconds(std::uint64_t nanoseconds)
+{
+    return static_cast<double>(nanoseconds) / 1000.0;
+}
+
+std::string Instrumentation::formatTable(const StatsSnapshot &stats)
+{
+    std::ostringstream table;
+    table << std::left << std::setw(18) << "operation" << std::right << std::setw(10) << "count" << std::setw(11) << "mean us"
+          << std::setw(11) << "p50 us" << std::setw(11) << "p99 us" << std::setw(11) << "p999 us" << std::setw(11) << "max us" << '\n';
+    table << std::fixed << std::setprecision(2);
+    for (std::size_t operation = 0; operation < stats.operations.size(); ++operation)
+    {
+        const HistogramSummary &summary = stats.operations[operation];
+        if (summary.count == 0)
+        {
+            continue;
+        }
+        table << std::left << std::setw(18) << operationNames[operation] << std::right << std::setw(10) << summary.count
+              << std::setw(11) << (summary.samples == 0 ? 0.0 : microseconds(summary.sum) / static_cast<double>(summary.samples)) << std::setw(11) << microseconds(summary.p50)
+              << std::setw(11) << microseconds(summary.p99) << std::setw(11) << microseconds(summary.p999) << std::setw(11) << microseconds(summary.maximum) << '\n';
+    }
+    table << std::left << std::setw(18) << "pathDepth" << "walks " << stats.pathDepth.count << ", p50 " << stats.pathDepth.p50 << ", p99 " << stats.pathDepth.p99 << ", max " << stats.pathDepth.maximum << '\n';
+    table << std::left << std::setw(18) << "findVisits" << "finds " << stats.findVisits.count << ", p50 " << stats.findVisits.p50 << ", p99 " << stats.findVisits.p99 << ", max " << stats.findVisits.maximum << '\n';
+    for (std::size_t counter = 0; counter < stats.counters.size(); ++counter)
+    {
+        table << std::left << std::setw(18) << counterNames[counter] << stats.counters[counter] << '\n';
+    }
+    return table.str();
+}
+
+static void appendSummaryJson(std::ostringstream &json, const HistogramSummary &summary)
+{
+    json << "{\"count\":" << summary.count << ",\"samples\":" << summary.samples << ",\"sum\":" << summary.sum << ",\"p50\":" << summary.p50 << ",\"p99\":" << summary.p99
+         << ",\"p999\":" << summary.p999 << ",\"max\":" << summary.maximum << '}';
+}
+
+std::string Instrumentation::formatJson(const StatsSnapshot &stats)
+{
+    std::ostringstream json;
+    json << "{\"operations\":{";
+    for (std::size_t operation = 0; operation < stats.operations.size(); ++operation)
+    {
+        json << (operation == 0 ? "\"" : ",\"") << operationNames[operation] << "\":";
+        appendSummaryJson(json, stats.operations[operation]);
+    }
+    json << "},\"pathDepth\":";
+    appendSummaryJson(json, stats.pathDepth);
+    json << ",\"findVisits\":";
+    appendSummaryJson(json, stats.findVisits);
+    json << ",\"counters\":{";
+    for (std::size_t counter = 0; counter < stats.counters.size(); ++counter)
+    {
+        json << (counter == 0 ? "\"" : ",\"") << counterNames[counter] << "\":" << stats.counters[counter];
+    }
+    json << "}}";
+    return json.str();
+}
+
+OperationTimer::~OperationTimer()
+{
+    Instrumentation::recordOperation(operation, sampled, sampled ? Instrumentation::ticks() - started : 0);
+    if (operation == StatOperation::Find)
+    {
+        Instrumentation::finishFind();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,284 @@
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "journal.hpp"
+
+static constexpr std::array<std::uint32_t, 256> makeCrcTable()
+{
+    std::array<std::uint32_t, 256> table{};
+    for (std::uint32_t index = 0; index < 256; ++index)
+    {
+        std::uint32_t value = index;
+        for (int bit = 0; bit < 8; ++bit)
+        {
+            value = (value & 1) != 0 ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+        }
+        table[index] = value;
+    }
+    return table;
+}
+
+static std::uint32_t checksum(std::string_view bytes)
+{
+    static constexpr std::array<std::uint32_t, 256> crcTable = makeCrcTable();
+    std::uint32_t crc = 0xFFFFFFFFu;
+    for (unsigned char byte : bytes)
+    {
+        crc = crcTable[(crc ^ byte) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+template <typename T>
+static void appendValue(std::string &buffer, T value)
+{
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+template <typename T>
+static bool readValue(std::string_view &bytes, T &value)
+{
+    if (bytes.size() < sizeof(value))
+    {
+        return false;
+    }
+    std::memcpy(&value, bytes.data(), sizeof(value));
+    bytes.remove_prefix(sizeof(value));
+    return true;
+}
+
+static bool readString(std::string_view &bytes, std::string &text)
+{
+    std::uint32_t length;
+    if (!readValue(bytes, length) || bytes.size() < length)
+    {
+        return false;
+    }
+    text.assign(bytes.substr(0, length));
+    bytes.remove_prefix(length);
+    return true;
+}
+
+static bool writeAll(int descriptor, std::string_view bytes)
+{
+    while (!bytes.empty())
+    {
+        ssize_t result = ::write(descriptor, bytes.data(), bytes.size());
+        if (result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (result <= 0)
+        {
+            return false;
+        }
+        bytes.remove_prefix(static_cast<std::size_t>(result));
+    }
+    return true;
+}
+
+Journal::Journal(int fileDescriptor, std::uint64_t existingBytes, const JournalOptions &journalOptions)
+    : descriptor(fileDescriptor), options(journalOptions), journalBytes(existingBytes)
+{
+    if (options.syncPolicy == SyncPolicy::Batch)
+    {
+        flusher = std::thread(&Journal::runFlusher, this);
+    }
+}
+
+Journal::~Journal()
+{
+    {
+        std::unique_lock<std::mutex> lock(journalMutex);
+        stopping = true;
+        flushRequested.notify_all();
+    }
+    if (flusher.joinable())
+    {
+        flusher.join();
+    }
+    sync();
+    ::close(descriptor);
+}
+
+FsResult<std::unique_ptr<Journal>> Journal::open(const std::string &path, const JournalOptions &options)
+{
+    int descriptor = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    struct stat status;
+    if (descriptor < 0 || ::fstat(descriptor, &status) != 0)
+    {
+        if (descriptor >= 0)
+        {
+            ::close(descriptor);
+        }
+        return FsResult<std::unique_ptr<Journal>>::failure(FsStatus::IoError, path);
+    }
+    std::uint64_t existingBytes = static_cast<std::uint64_t>(status.st_size);
+    if (existingBytes == 0)
+    {
+        if (!writeAll(descriptor, std::string_view(magic, sizeof(magic))) || ::fsync(descriptor) != 0)
+        {
+            ::close(descriptor);
+            return FsResult<std::unique_ptr<Journal>>::failure(FsStatus::IoError, path);
+        }
+        existingBytes = sizeof(magic);
+    }
+    return FsResult<std::unique_ptr<Journal>>::success(std::unique_ptr<Journal>(new Journal(descriptor, existingBytes, options)));
+}
+
+FsResult<std::size_t> Journal::replay(const std::string &path, const std::function<void(const JournalRecord &)> &apply)
+{
+    std::ifstream input(path, std::ios::binary);
+    if (!input)
+    {
+        return FsResult<std::size_t>::success(0);
+    }
+    std::string contents((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    input.close();
+    if (contents.size() >= sizeof(magic) && std::memcmp(contents.data(), magic, sizeof(magic)) != 0)
+    {
+        return FsResult<std::size_t>::failure(FsStatus::CorruptData, path);
+    }
+
+    std::string_view remaining(contents);
+    remaining.remove_prefix(std::min(remaining.size(), sizeof(magic)));
+    std::size_t replayed = 0;
+    while (!remaining.empty())
+    {
+        std::string_view frame = remaining;
+        std::uint32_t payloadLength;
+        std::uint32_t expectedChecksum;
+        if (!readValue(frame, payloadLength) || !readValue(frame, expectedChecksum) || frame.size() < payloadLength ||
+            checksum(frame.substr(0, payloadLength)) != expectedChecksum)
+        {
+            break;
+        }
+        std::string_view payload = frame.substr(0, payloadLength);
+        JournalRecord record;
+        std::int64_t time;
+        if (!readValue(payload, record.operation) || !readValue(payload, time) || !readString(payload, record.path) || !readString(payload, record.text))
+        {
+            break;
+        }
+        record.time = Timestamp(std::chrono::nanoseconds(time));
+        apply(record);
+        ++replayed;
+        remaining = frame.substr(payloadLength);
+    }
+    if (!remaining.empty() || contents.size() < sizeof(magic))
+    {
+        std::error_code error;
+        std::filesystem::resize_file(path, contents.size() < sizeof(magic) ? 0 : contents.size() - remaining.size(), error);
+        if (error)
+        {
+            return FsResult<std::size_t>::failure(FsStatus::IoError, path);
+        }
+    }
+    return FsResult<std::size_t>::success(replayed);
+}
+
+bool Journal::append(const JournalRecord &record)
+{
+    std::string payload;
+    payload.reserve(1 + sizeof(std::int64_t) + 2 * sizeof(std::uint32_t) + record.path.size() + record.text.size());
+    appendValue(payload, record.operation);
+    appendValue(payload, static_cast<std::int64_t>(record.time.time_since_epoch().count()));
+    appendValue(payload, static_cast<std::uint32_t>(record.path.size()));
+    payload.append(record.path);
+    appendValue(payload, static_cast<std::uint32_t>(record.text.size()));
+    payload.append(record.text);
+
+    std::unique_lock<std::mutex> lock(journalMutex);
+    appendValue(pendingBytes, static_cast<std::uint32_t>(payload.size()));
+    appendValue(pendingBytes, checksum(payload));
+    pendingBytes.append(payload);
+    journalBytes += 2 * sizeof(std::uint32_t) + payload.size();
+    std::uint64_t sequence = ++appendedSequence;
+    if (options.syncPolicy == SyncPolicy::Always)
+    {
+        waitDurable(lock, sequence);
+    }
+    else if (pendingBytes.size() >= options.batchBytes)
+    {
+        if (options.syncPolicy == SyncPolicy::Batch)
+        {
+            flushRequested.notify_one();
+        }
+        else if (!flushing)
+        {
+            flushPending(lock);
+        }
+    }
+    return healthy;
+}
+
+bool Journal::sync()
+{
+    std::unique_lock<std::mutex> lock(journalMutex);
+    waitDurable(lock, appendedSequence);
+    if (options.syncPolicy == SyncPolicy::Never)
+    {
+        lock.unlock();
+        bool synced = ::fdatasync(descriptor) == 0;
+        lock.lock();
+        healthy = healthy && synced;
+    }
+    return healthy;
+}
+
+std::uint64_t Journal::size()
+{
+    std::lock_guard<std::mutex> lock(journalMutex);
+    return journalBytes;
+}
+
+void Journal::flushPending(std::unique_lock<std::mutex> &lock)
+{
+    flushing = true;
+    std::string batch;
+    batch.swap(pendingBytes);
+    std::uint64_t batchEnd = appendedSequence;
+    lock.unlock();
+    bool written = writeAll(descriptor, batch) && (options.syncPolicy == SyncPolicy::Never || ::fdatasync(descriptor) == 0);
+    lock.lock();
+    flushing = false;
+    healthy = healthy && written;
+    durableSequence = batchEnd;
+    durableChanged.notify_all();
+}
+
+void Journal::waitDurable(std::unique_lock<std::mutex> &lock, std::uint64_t sequence)
+{
+    while (durableSequence < sequence)
+    {
+        if (flushing)
+        {
+            durableChanged.wait(lock);
+        }
+        else
+        {
+            flushPending(lock);
+        }
+    }
+}
+
+void Journal::runFlusher()
+{
+    std::unique_lock<std::mutex> lock(journalMutex);
+    while (!stopping)
+    {
+        flushRequested.wait_for(lock, options.batchInterval, [this]()
+                                { return stopping || pendingBytes.size() >= options.batchBytes; });
+        if (!pendingBytes.empty() && !flushing)
+        {
+            flushPending(lock);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <iomanip>
+#include <shared_mutex>
+#include <sstream>
+#include <unordered_set>
+#include <vector>
+
+#include "memoryReport.hpp"
+#include "file.hpp"
+#include "nodeArena.hpp"
+#include "treeContext.hpp"
+
+// Approximates a general-purpose malloc: an 8-byte header, 16-byte alignment and a 32-byte minimum chunk.
+static std::size_t heapFootprint(std::size_t bytes)
+{
+    return std::max<std::size_t>(32, (bytes + 8 + 15) / 16 * 16);
+}
+
+// allocate_shared places the object after the control block's vptr, both counts and the allocator copy.
+template <typename Node>
+static std::size_t sharedNodeFootprint()
+{
+    std::size_t controlBlock = sizeof(void *) + 2 * sizeof(int) + sizeof(ArenaAllocator<Node>);
+    std::size_t aligned = (controlBlock + alignof(Node) - 1) / alignof(Node) * alignof(Node);
+    return NodeArena::pooledSize(aligned + sizeof(Node));
+}
+
+std::size_t MemoryReport::metadataBytes() const
+{
+    return files.nodeBytes + files.chunkTableBytes + directories.nodeBytes + directories.childTableBytes + snapshotBytes + internedNameBytes + indexBytes();
+}
+
+std::size_t MemoryReport::metadataPerFile() const
+{
+    return files.count == 0 ? 0 : metadataBytes() / files.count;
+}
+
+MemoryReport measureMemory(const Directory &root)
+{
+    MemoryReport report;
+    std::unordered_set<std::string_view> distinctNames;
+    std::unordered_set<const File *> subtreeFiles;
+    std::unordered_set<const NameInterner::Entry *> internedEntries;
+    auto countName = [&](const FileSystemComponent &component)
+    {
+        const NodeName &name = component.getNodeName();
+        if (!name.isInterned())
+        {
+            ++report.inlineNames;
+        }
+        else if (internedEntries.insert(name.internedEntry()).second)
+        {
+            ++report.internedNames;
+            report.internedNameBytes += NameInterner::entryFootprint(name.size());
+        }
+    };
+
+    std::vector<const Directory *> pending{&root};
+    countName(root);
+    ++report.directories.count;
+    report.directories.nodeBytes += sharedNodeFootprint<Directory>();
+    while (!pending.empty())
+    {
+        const Directory *directory = pending.back();
+        pending.pop_back();
+        report.directories.childTableBytes += directory->getChildren().allocatedBytes();
+        report.snapshotBytes += directory->getSnapshotBytes();
+        report.extensionIndexBytes += directory->getExtensionCount() * heapFootprint(sizeof(void *) + sizeof(std::string) + sizeof(std::unordered_set<void *>) + sizeof(std::size_t));
+        for (auto &child : directory->getChildren())
+        {
+            countName(*child.second);
+            if (const File *file = asFile(child.second.get()))
+            {
+                ++report.files.count;
+                report.files.nodeBytes += sharedNodeFootprint<File>();
+                report.files.chunkTableBytes += file->getFileContent().chunkTableBytes();
+                report.files.contentBytes += file->getFileContent().allocatedBytes();
+                distinctNames.insert(file->getNameView());
+                subtreeFiles.insert(file);
+                report.extensionIndexBytes += heapFootprint(2 * sizeof(void *)) + sizeof(void *);
+            }
+            else if (const Directory *subdirectory = asDirectory(child.second.get()))
+            {
+                ++report.directories.count;
+                report.directories.nodeBytes += sharedNodeFootprint<Directory>();
+                report.extensionIndexBytes += heapFootprint(2 * sizeof(void *)) + sizeof(void *);
+                pending.push_back(subdirectory);
+            }
+        }
+    }
+    // Name index: one map node and one inner set per distinct name, one set node per file; time index: one tree node per file.
+    report.nameIndexBytes = distinctNames.size() * (heapFootprint(sizeof(void *) + sizeof(NodeName) + sizeof(std::unordered_set<void *>) + sizeof(std::size_t)) + 2 * sizeof(void *)) + report.files.count * (heapFootprint(2 * sizeof(void *)) + sizeof(void *));
+    report.timeIndexBytes = report.files.count * heapFootprint(4 * sizeof(void *) + sizeof(Timestamp) + sizeof(void *));
+    // Content index: one map node per trigram that occurs under this directory, one set node per posting from one of its files.
+    TreeContext *context = root.getContext();
+    if (context != nullptr)
+    {
+        std::shared_lock<std::shared_mutex> indexLock(context->indexMutex);
+        if (context->contentIndex != nullptr)
+        {
+            context->contentIndex->forEachPostingList([&](const std::unordered_set<File *> &postingList)
+                                                      {
+                std::size_t postings = 0;
+                for (File *file : postingList)
+                {
+                    postings += subtreeFiles.count(file);
+                }
+                if (postings != 0)
+                {
+                    report.contentIndexBytes += heapFootprint(sizeof(void *) + sizeof(std::pair<const std::uint32_t, std::unordered_set<File *>>)) + 2 * sizeof(void *) + postings * (heapFootprint(2 * sizeof(void *)) + sizeof(void *));
+                } });
+        }
+    }
+    return report;
+}
+
+static void formatRow(std::ostringstream &table, const char *kind, const NodeMemory &usage)
+{
+    std::size_t metadata = usage.nodeBytes + usage.childTableBytes + usage.chunkTableBytes;
+    table << std::left << std::setw(12) << kind << std::right << std::setw(12) << usage.count << std::setw(14) << usage.nodeBytes
+          << std::setw(14) << usage.childTableBytes << std::setw(14) << usage.chunkTableBytes << std::setw(14) << usage.contentBytes
+          << std::setw(10) << (usage.count == 0 ? 0 : metadata / usage.count) << '\n';
+}
+
+std::string formatMemoryReport(const MemoryReport &report)
+{
+    std::ostringstream table;
+    table << std::left << std::setw(12) << "kind" << std::right << std::setw(12) << "count" << std::setw(14) << "nodes"
+          << std::setw(14) << "children" << std::setw(14) << "chunkTables" << std::setw(14) << "content" << std::setw(10) << "perNode" << '\n';
+    formatRow(table, "file", report.files);
+    formatRow(table, "directory", report.directories);
+    table << "names: " << report.inlineNames << " inline, " << report.internedNames << " interned (" << report.internedNameBytes << " bytes)\n";
+    table << "lock-free snapshots: " << report.snapshotBytes << " bytes\n";
+    table << "indexes (estimated): name " << report.nameIndexBytes << ", time " << report.timeIndexBytes << ", extension " << report.extensionIndexBytes << ", content " << report.contentIndexBytes << " bytes\n";
+    table << "metadata: " << report.metadataBytes() << " bytes, " << report.metadataPerFile() << " per file\n";
+    return table.str();
+}
\ No newline at end of file
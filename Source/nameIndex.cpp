@@ -0,0 +1,50 @@
+#include "nameIndex.hpp"
+#include "directory.hpp"
+#include "file.hpp"
+
+void NameIndex::addSubtree(FileSystemComponent *component)
+{
+    if (File *file = asFile(component))
+    {
+        if (filesByName[file->getNodeName()].insert(file).second)
+        {
+            ++indexedFiles;
+        }
+    }
+    else if (Directory *directory = asDirectory(component))
+    {
+        for (auto &child : directory->getChildren())
+        {
+            addSubtree(child.second.get());
+        }
+    }
+}
+
+void NameIndex::removeSubtree(FileSystemComponent *component)
+{
+    if (File *file = asFile(component))
+    {
+        auto foundName = filesByName.find(file->getNameView());
+        if (foundName != filesByName.end() && foundName->second.erase(file) != 0)
+        {
+            --indexedFiles;
+            if (foundName->second.empty())
+            {
+                filesByName.erase(foundName);
+            }
+        }
+    }
+    else if (Directory *directory = asDirectory(component))
+    {
+        for (auto &child : directory->getChildren())
+        {
+            removeSubtree(child.second.get());
+        }
+    }
+}
+
+const std::unordered_set<File *> *NameIndex::find(std::string_view name) const
+{
+    auto foundName = filesByName.find(name);
+    return foundName == filesByName.end() ? nullptr : &foundName->second;
+}
\ No newline at end of file
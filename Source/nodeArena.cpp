@@ -0,0 +1,87 @@
+#include "instrumentation.hpp"
+#include "nodeArena.hpp"
+
+void *NodeArena::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    if (bytes > largestPooledSize || alignment > granularity)
+    {
+        void *pointer = ::operator new(bytes, std::align_val_t(alignment));
+        std::lock_guard<std::mutex> lock(arenaMutex);
+        ++liveLargeAllocations;
+        return pointer;
+    }
+    std::size_t roundedBytes = pooledSize(bytes);
+    VFS_STATS(Instrumentation::count(StatCounter::NodeAllocations));
+    std::lock_guard<std::mutex> lock(arenaMutex);
+    ++liveAllocations;
+    FreeBlock *&freeList = freeLists[roundedBytes / granularity - 1];
+    if (freeList != nullptr)
+    {
+        FreeBlock *block = freeList;
+        freeList = block->next;
+        return block;
+    }
+    if (slabCursor == nullptr || static_cast<std::size_t>(slabEnd - slabCursor) < roundedBytes)
+    {
+        VFS_STATS(Instrumentation::count(StatCounter::SlabAllocations));
+        slabs.emplace_back(new std::byte[slabSize]);
+        slabCursor = slabs.back().get();
+        slabEnd = slabCursor + slabSize;
+    }
+    void *pointer = slabCursor;
+    slabCursor += roundedBytes;
+    return pointer;
+}
+
+void NodeArena::do_deallocate(void *pointer, std::size_t bytes, std::size_t alignment)
+{
+    bool lastAllocation;
+    if (bytes > largestPooledSize || alignment > granularity)
+    {
+        ::operator delete(pointer, std::align_val_t(alignment));
+        std::lock_guard<std::mutex> lock(arenaMutex);
+        --liveLargeAllocations;
+        lastAllocation = released && liveAllocations + liveLargeAllocations == 0;
+    }
+    else
+    {
+        std::size_t roundedBytes = pooledSize(bytes);
+        std::lock_guard<std::mutex> lock(arenaMutex);
+        --liveAllocations;
+        FreeBlock *&freeList = freeLists[roundedBytes / granularity - 1];
+        FreeBlock *block = static_cast<FreeBlock *>(pointer);
+        block->next = freeList;
+        freeList = block;
+        lastAllocation = released && liveAllocations + liveLargeAllocations == 0;
+    }
+    if (lastAllocation)
+    {
+        delete this;
+    }
+}
+
+void NodeArena::release()
+{
+    bool unused;
+    {
+        std::lock_guard<std::mutex> lock(arenaMutex);
+        released = true;
+        unused = liveAllocations + liveLargeAllocations == 0;
+    }
+    if (unused)
+    {
+        delete this;
+    }
+}
+
+std::size_t NodeArena::getLiveAllocations()
+{
+    std::lock_guard<std::mutex> lock(arenaMutex);
+    return liveAllocations;
+}
+
+std::size_t NodeArena::getReservedBytes()
+{
+    std::lock_guard<std::mutex> lock(arenaMutex);
+    return slabs.size() * slabSize;
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include <new>
+
+#include "nodeName.hpp"
+
+NameInterner &NameInterner::instance()
+{
+    static NameInterner *interner = new NameInterner;
+    return *interner;
+}
+
+const NameInterner::Entry *NameInterner::acquire(std::string_view name)
+{
+    std::size_t hash = std::hash<std::string_view>{}(name);
+    Shard &shard = shards[hash % shardCount];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto found = shard.entries.find(name);
+    if (found != shard.entries.end())
+    {
+        std::uint32_t references = (*found)->references.load(std::memory_order_relaxed);
+        while (references != 0 && !(*found)->references.compare_exchange_weak(references, references + 1, std::memory_order_relaxed))
+        {
+        }
+        if (references != 0)
+        {
+            return *found;
+        }
+        // The last holder is about to free it; unlink it so that holder does not find it again.
+        shard.bytes -= entryFootprint((*found)->length);
+        shard.entries.erase(found);
+    }
+    void *storage = ::operator new(entryFootprint(name.size()));
+    Entry *entry = new (storage) Entry;
+    entry->length = static_cast<std::uint32_t>(name.size());
+    entry->hash = hash;
+    std::memcpy(const_cast<char *>(entry->characters()), name.data(), name.size());
+    shard.entries.insert(entry);
+    shard.bytes += entryFootprint(name.size());
+    return entry;
+}
+
+void NameInterner::release(const Entry *entry)
+{
+    if (entry->references.fetch_sub(1, std::memory_order_acq_rel) != 1)
+    {
+        return;
+    }
+    Shard &shard = shards[entry->hash % shardCount];
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto found = shard.entries.find(entry);
+        if (found != shard.entries.end() && *found == entry)
+        {
+            shard.bytes -= entryFootprint(entry->length);
+            shard.entries.erase(found);
+        }
+    }
+    entry->~Entry();
+    ::operator delete(const_cast<Entry *>(entry));
+}
+
+std::size_t NameInterner::internedCount()
+{
+    std::size_t count = 0;
+    for (Shard &shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        count += shard.entries.size();
+    }
+    return count;
+}
+
+std::size_t NameInterner::internedBytes()
+{
+    std::size_t bytes = 0;
+    for (Shard &shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        bytes += shard.bytes;
+    }
+    return bytes;
+}
+
+void NodeName::assign(std::string_view name)
+{
+    std::memset(inlineCharacters, 0, sizeof(inlineCharacters));
+    if (name.size() <= inlineCapacity)
+    {
+        std::memcpy(inlineCharacters, name.data(), name.size());
+        tag() = static_cast<unsigned char>(name.size());
+        return;
+    }
+    interned = NameInterner::instance().acquire(name);
+    tag() = internedTag;
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include <cerrno>
+#include <unistd.h>
+
+#include "outputSink.hpp"
+
+void BufferedStreamSink::write(std::string_view text)
+{
+    buffer.append(text);
+    if (buffer.size() >= capacity)
+    {
+        stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+}
+
+void BufferedStreamSink::flush()
+{
+    if (!buffer.empty())
+    {
+        stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+    stream.flush();
+}
+
+void VectorSink::write(std::string_view text)
+{
+    std::size_t lineEnd;
+    while ((lineEnd = text.find('\n')) != std::string_view::npos)
+    {
+        pendingLine.append(text.substr(0, lineEnd));
+        lines.push_back(std::move(pendingLine));
+        pendingLine.clear();
+        text.remove_prefix(lineEnd + 1);
+    }
+    pendingLine.append(text);
+}
+
+void VectorSink::flush()
+{
+    if (!pendingLine.empty())
+    {
+        lines.push_back(std::move(pendingLine));
+        pendingLine.clear();
+    }
+}
+
+void VectorSink::clear()
+{
+    lines.clear();
+    pendingLine.clear();
+}
+
+void FileDescriptorSink::write(std::string_view text)
+{
+    buffer.append(text);
+    if (buffer.size() >= capacity)
+    {
+        flush();
+    }
+}
+
+void FileDescriptorSink::flush()
+{
+    std::size_t written = 0;
+    while (written < buffer.size())
+    {
+        ssize_t result = ::write(fileDescriptor, buffer.data() + written, buffer.size() - written);
+        if (result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (result <= 0)
+        {
+            break;
+        }
+        written += static_cast<std::size_t>(result);
+    }
+    buffer.clear();
+}
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include "instrumentation.hpp"
+#include "pathResolver.hpp"
+
+bool PathTokenizer::isAbsolute() const
+{
+    return (!path.empty() && path.front() == '/') || path == "~" || path.substr(0, 2) == "~/";
+}
+
+bool PathTokenizer::next(std::string_view &segment)
+{
+    while (position < path.size())
+    {
+        while (position < path.size() && path[position] == '/')
+        {
+            ++position;
+        }
+        std::size_t start = position;
+        while (position < path.size() && path[position] != '/')
+        {
+            ++position;
+        }
+        segment = path.substr(start, position - start);
+        if (segment.empty() || segment == "." || (start == 0 && segment == "~"))
+        {
+            continue;
+        }
+        return true;
+    }
+    return false;
+}
+
+std::size_t PathResolver::CacheKeyHash::operator()(const CacheKeyView &key) const
+{
+    std::size_t pathHash = std::hash<std::string_view>{}(key.path);
+    return pathHash ^ (std::hash<const Directory *>{}(key.baseDirectory) + 0x9e3779b97f4a7c15ULL + (pathHash << 6) + (pathHash >> 2));
+}
+
+ResolvedPath PathResolver::walk(std::string_view path, Directory *rootDirectory, Directory *baseDirectory)
+{
+    PathTokenizer tokenizer(path);
+    FileSystemComponent *current = tokenizer.isAbsolute() ? rootDirectory : baseDirectory;
+    std::string_view segment;
+    VFS_STATS(std::size_t depth = 0);
+    while (tokenizer.next(segment))
+    {
+        VFS_STATS(++depth);
+        Directory *currentDirectory = asDirectory(current);
+        if (currentDirectory == nullptr)
+        {
+            VFS_STATS(Instrumentation::recordPathDepth(depth));
+            return {nullptr, segment};
+        }
+        if (segment == "..")
+        {
+            if (currentDirectory != rootDirectory && currentDirectory->getParent() != nullptr)
+            {
+                current = currentDirectory->getParent();
+            }
+            continue;
+        }
+        current = currentDirectory->findChild(segment);
+        if (current == nullptr)
+        {
+            VFS_STATS(Instrumentation::recordPathDepth(depth));
+            return {nullptr, segment};
+        }
+    }
+    VFS_STATS(Instrumentation::recordPathDepth(depth));
+    return {current, {}};
+}
+
+FileSystemComponent *PathResolver::findCached(std::string_view path, Directory *baseDirectory)
+{
+    auto foundEntry = cache.find(CacheKeyView{baseDirectory, path});
+    if (foundEntry == cache.end())
+    {
+        return nullptr;
+    }
+    auto entry = foundEntry->second;
+    if (entry->generation != baseDirectory->getContext()->generation || entry->baseDirectory.expired())
+    {
+        cache.erase(foundEntry);
+        recentlyUsed.erase(entry);
+        return nullptr;
+    }
+    recentlyUsed.splice(recentlyUsed.begin(), recentlyUsed, entry);
+    return entry->component;
+}
+
+void PathResolver::storeCached(std::string_view path, Directory *baseDirectory, FileSystemComponent *component)
+{
+    std::weak_ptr<Directory> weakBase = baseDirectory->weak_from_this();
+    if (capacity == 0 || weakBase.expired())
+    {
+        return;
+    }
+    if (cache.size() >= capacity)
+    {
+        cache.erase(recentlyUsed.back().key);
+        recentlyUsed.pop_back();
+    }
+    recentlyUsed.push_front(CacheEntry{CacheKey{baseDirectory, std::string(path)}, weakBase, baseDirectory->getContext()->generation, component});
+    cache.emplace(recentlyUsed.front().key, recentlyUsed.begin());
+}
+
+ResolvedPath PathResolver::resolve(std::string_view path, Directory *rootDirectory, Directory *baseDirectory)
+{
+    bool cacheable = baseDirectory->getContext() != nullptr && baseDirectory->getContext() == rootDirectory->getContext();
+    if (cacheable)
+    {
+        FileSystemComponent *cachedComponent = findCached(path, baseDirectory);
+        if (cachedComponent != nullptr)
+        {
+            VFS_STATS(Instrumentation::count(StatCounter::PathCacheHits));
+            return {cachedComponent, {}};
+        }
+    }
+    ResolvedPath resolved = walk(path, rootDirectory, baseDirectory);
+    if (cacheable && resolved.component != nullptr)
+    {
+        storeCached(path, baseDirectory, resolved.component);
+    }
+    return resolved;
+}
+
+ResolvedPath PathResolver::resolveParent(std::string_view path, Directory *rootDirectory, Directory *baseDirectory, std::string_view &leafName)
+{
+    std::size_t end = path.find_last_not_of('/');
+    if (end == std::string_view::npos)
+    {
+        leafName = {};
+        return {nullptr, path};
+    }
+    path = path.substr(0, end + 1);
+    std::size_t separator = path.rfind('/');
+    std::string_view parentPath;
+    if (separator == std::string_view::npos)
+    {
+        leafName = path;
+    }
+    else
+    {
+        leafName = path.substr(separator + 1);
+        parentPath = path.substr(0, separator == 0 ? 1 : separator);
+    }
+    if (!isValidNodeName(leafName))
+    {
+        return {nullptr, leafName, true};
+    }
+    ResolvedPath resolved = resolve(parentPath, rootDirectory, baseDirectory);
+    if (resolved.component != nullptr && asDirectory(resolved.component) == nullptr)
+    {
+        std::size_t parentSeparator = parentPath.find_last_of('/');
+        resolved.missingSegment = parentSeparator == std::string_view::npos ? parentPath : parentPath.substr(parentSeparator + 1);
+        resolved.component = nullptr;
+    }
+    return resolved;
+}
+
+void PathResolver::clear()
+{
+    cache.clear();
+    recentlyUsed.clear();
+}
\ No newline at end of file
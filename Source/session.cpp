@@ -0,0 +1,313 @@
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+
+#include "session.hpp"
+
+Session::Session(FileSystem &sharedFileSystem) : fileSystem(sharedFileSystem)
+{
+    workingPath.directories.push_back(fileSystem.getRootDirectory());
+}
+
+std::string Session::pathString(const WalkedPath &walked)
+{
+    std::string path = "~";
+    for (auto &name : walked.names)
+    {
+        path += '/';
+        path += name;
+    }
+    return path;
+}
+
+FsResult<> Session::walk(std::string_view path, bool stopBeforeLeaf, WalkedPath &walked, std::string &leafName) const
+{
+    PathTokenizer tokenizer(path);
+    std::vector<std::string_view> segments;
+    std::string_view segment;
+    while (tokenizer.next(segment))
+    {
+        segments.push_back(segment);
+    }
+    if (tokenizer.isAbsolute())
+    {
+        walked.directories.assign(1, workingPath.directories.front());
+        walked.names.clear();
+    }
+    else
+    {
+        walked = workingPath;
+    }
+    if (stopBeforeLeaf)
+    {
+        std::string_view trimmedPath = path.substr(0, path.find_last_not_of('/') + 1);
+        if (segments.empty() || !isValidNodeName(trimmedPath.substr(trimmedPath.rfind('/') + 1)))
+        {
+            return FsResult<>::failure(FsStatus::InvalidArgument, std::string(path));
+        }
+        leafName = segments.back();
+        segments.pop_back();
+    }
+
+    std::shared_lock<std::shared_mutex> heldLock;
+    for (std::string_view name : segments)
+    {
+        if (name == "..")
+        {
+            if (heldLock.owns_lock())
+            {
+                heldLock.unlock();
+            }
+            if (walked.directories.size() > 1)
+            {
+                walked.directories.pop_back();
+                walked.names.pop_back();
+            }
+            continue;
+        }
+        Directory &current = *walked.directories.back();
+        if (!heldLock.owns_lock() && !current.hasLockFreeReads())
+        {
+            heldLock = std::shared_lock<std::shared_mutex>(current.getMutex());
+        }
+        std::shared_ptr<FileSystemComponent> child = current.getChild(name);
+        if (child == nullptr)
+        {
+            return FsResult<>::failure(FsStatus::PathNotFound, std::string(name));
+        }
+        if (!child->isDirectory())
+        {
+            return FsResult<>::failure(FsStatus::NotADirectory, std::string(name));
+        }
+        std::shared_ptr<Directory> childDirectory = std::static_pointer_cast<Directory>(std::move(child));
+        std::shared_lock<std::shared_mutex> childLock;
+        if (!childDirectory->hasLockFreeReads())
+        {
+            childLock = std::shared_lock<std::shared_mutex>(childDirectory->getMutex());
+        }
+        heldLock.swap(childLock);
+        walked.directories.push_back(std::move(childDirectory));
+        walked.names.emplace_back(name);
+    }
+    return FsResult<>::success({});
+}
+
+FsResult<> Session::changeDirectory(const std::string &path)
+{
+    WalkedPath walked;
+    std::string unused;
+    FsResult<> result = walk(path, false, walked, unused);
+    if (result.ok())
+    {
+        workingPath = std::move(walked);
+    }
+    return result;
+}
+
+FsResult<> Session::createDirectory(const std::string &path)
+{
+    PathTokenizer tokenizer(path);
+    std::vector<std::shared_ptr<Directory>> directories;
+    if (tokenizer.isAbsolute())
+    {
+        directories.push_back(workingPath.directories.front());
+    }
+    else
+    {
+        directories = workingPath.directories;
+    }
+    std::string_view name;
+    while (tokenizer.next(name))
+    {
+        if (name == "..")
+        {
+            if (directories.size() > 1)
+            {
+                directories.pop_back();
+            }
+            continue;
+        }
+        Directory *current = directories.back().get();
+        std::shared_ptr<FileSystemComponent> child;
+        {
+            std::shared_lock<std::shared_mutex> readLock(current->getMutex());
+            child = current->getChild(name);
+        }
+        if (child == nullptr)
+        {
+            std::unique_lock<std::shared_mutex> writeLock(current->getMutex());
+            child = current->getChild(name);
+            if (child == nullptr)
+            {
+                if (!isValidNodeName(name))
+                {
+                    return FsResult<>::failure(FsStatus::InvalidArgument, std::string(name));
+                }
+                child = fileSystem.makeDirectory(std::string(name));
+                current->addChild(child);
+            }
+        }
+        if (!child->isDirectory())
+        {
+            return FsResult<>::failure(FsStatus::NotADirectory, std::string(name));
+        }
+        directories.push_back(std::static_pointer_cast<Directory>(std::move(child)));
+    }
+    return FsResult<>::success({});
+}
+
+FsResult<> Session::createFile(const std::string &path)
+{
+    WalkedPath walked;
+    std::string fileName;
+    FsResult<> result = walk(path, true, walked, fileName);
+    if (result.ok())
+    {
+        std::shared_ptr<File> file = fileSystem.makeFile(fileName);
+        Directory &parent = *walked.directories.back();
+        std::unique_lock<std::shared_mutex> writeLock(parent.getMutex());
+        parent.addChild(file);
+    }
+    return result;
+}
+
+FsResult<> Session::appendToFile(const std::string &path, const std::string &text)
+{
+    WalkedPath walked;
+    std::string fileName;
+    FsResult<> result = walk(path, true, walked, fileName);
+    if (!result.ok())
+    {
+        return result;
+    }
+    Directory &parent = *walked.directories.back();
+    std::shared_lock<std::shared_mutex> readLock(parent.getMutex());
+    File *file = asFile(parent.findChild(fileName));
+    if (file == nullptr)
+    {
+        return FsResult<>::failure(parent.findChild(fileName) == nullptr ? FsStatus::NotFound : FsStatus::NotAFile, fileName);
+    }
+    file->setContent(text);
+    return result;
+}
+
+FsResult<std::string> Session::readFile(const std::string &path) const
+{
+    WalkedPath walked;
+    std::string fileName;
+    FsResult<> result = walk(path, true, walked, fileName);
+    if (!result.ok())
+    {
+        return FsResult<std::string>::failure(result.status, std::move(result.detail));
+    }
+    Directory &parent = *walked.directories.back();
+    std::shared_lock<std::shared_mutex> readLock;
+    if (!parent.hasLockFreeReads())
+    {
+        readLock = std::shared_lock<std::shared_mutex>(parent.getMutex());
+    }
+    std::shared_ptr<FileSystemComponent> component = parent.getChild(fileName);
+    File *file = asFile(component.get());
+    if (file == nullptr)
+    {
+        return FsResult<std::string>::failure(component == nullptr ? FsStatus::NotFound : FsStatus::NotAFile, fileName);
+    }
+    std::shared_lock<std::shared_mutex> contentLock(TreeContext::contentMutexFor(file));
+    return FsResult<std::string>::success(file->getContent());
+}
+
+FsResult<std::vector<std::string>> Session::listDirectory(const std::string &path, const ListingCursor &cursor, const std::string &pattern) const
+{
+    WalkedPath walked;
+    std::string unused;
+    FsResult<> result = walk(path, false, walked, unused);
+    if (!result.ok())
+    {
+        return FsResult<std::vector<std::string>>::failure(result.status, std::move(result.detail));
+    }
+    std::optional<GlobPattern> compiledPattern;
+    if (!pattern.empty())
+    {
+        compiledPattern.emplace(pattern);
+    }
+    std::vector<std::string> names;
+    Directory &directory = *walked.directories.back();
+    std::shared_lock<std::shared_mutex> readLock(directory.getMutex());
+    directory.forEachListedChild(cursor, compiledPattern ? &*compiledPattern : nullptr, [&names](const ChildTable::Entry &child)
+                                 { names.push_back(child.first.str()); });
+    return FsResult<std::vector<std::string>>::success(std::move(names));
+}
+
+FsResult<> Session::removeDirectory(const std::string &path, bool recursive)
+{
+    WalkedPath walked;
+    std::string directoryName;
+    FsResult<> result = walk(path, true, walked, directoryName);
+    if (!result.ok())
+    {
+        return result;
+    }
+    Directory &parent = *walked.directories.back();
+    std::unique_lock<std::shared_mutex> parentLock(parent.getMutex());
+    FileSystemComponent *component = parent.findChild(directoryName);
+    Directory *directory = asDirectory(component);
+    if (directory == nullptr)
+    {
+        return FsResult<>::failure(component == nullptr ? FsStatus::NotFound : FsStatus::NotADirectory, directoryName);
+    }
+    std::unique_lock<std::shared_mutex> directoryLock(directory->getMutex());
+    if (recursive)
+    {
+        std::shared_ptr<FileSystemComponent> subtree = parent.detachSubtree(directoryName);
+        directoryLock.unlock();
+        fileSystem.reclaimSubtree(std::move(subtree), parent.getSharedContext());
+        return result;
+    }
+    if (!directory->getChildren().empty())
+    {
+        return FsResult<>::failure(FsStatus::DirectoryNotEmpty, directoryName);
+    }
+    std::shared_ptr<FileSystemComponent> keepAlive = parent.getChild(directoryName);
+    parent.removeChild(directoryName);
+    directoryLock.unlock();
+    return result;
+}
+
+FsResult<std::size_t> Session::removeFiles(const std::string &pattern)
+{
+    WalkedPath walked;
+    std::string leafPattern;
+    FsResult<> result = walk(pattern, true, walked, leafPattern);
+    if (!result.ok())
+    {
+        return FsResult<std::size_t>::failure(result.status, std::move(result.detail));
+    }
+    Directory &parent = *walked.directories.back();
+    std::unique_lock<std::shared_mutex> writeLock(parent.getMutex());
+    std::size_t removedCount = 0;
+    for (FileSystemComponent *child : parent.findMatchingChildren(GlobPattern(leafPattern)))
+    {
+        if (child->isFile())
+        {
+            parent.removeChild(child->getName());
+            ++removedCount;
+        }
+    }
+    if (removedCount == 0)
+    {
+        return FsResult<std::size_t>::failure(FsStatus::NotFound, leafPattern);
+    }
+    return FsResult<std::size_t>::success(removedCount);
+}
+
+FsResult<std::vector<std::string>> Session::find(const FindQuery &query) const
+{
+    WalkedPath walked;
+    std::string unused;
+    FsResult<> result = walk(query.startPath, false, walked, unused);
+    if (!result.ok())
+    {
+        return FsResult<std::vector<std::string>>::failure(result.status, std::move(result.detail));
+    }
+    return fileSystem.findUnder(query, *walked.directories.back(), pathString(walked));
+}
\ No newline at end of file
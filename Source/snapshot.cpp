@@ -0,0 +1,233 @@
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include "snapshot.hpp"
+#include "fileSystem.hpp"
+
+MappedFile::~MappedFile()
+{
+    if (address != nullptr)
+    {
+        ::munmap(address, length);
+    }
+}
+
+FsResult<std::shared_ptr<MappedFile>> MappedFile::open(const std::string &path)
+{
+    int descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (descriptor < 0)
+    {
+        return FsResult<std::shared_ptr<MappedFile>>::failure(FsStatus::IoError, path);
+    }
+    struct stat status;
+    if (::fstat(descriptor, &status) != 0 || status.st_size <= 0)
+    {
+        ::close(descriptor);
+        return FsResult<std::shared_ptr<MappedFile>>::failure(FsStatus::CorruptData, path);
+    }
+    std::size_t length = static_cast<std::size_t>(status.st_size);
+    void *address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor);
+    if (address == MAP_FAILED)
+    {
+        return FsResult<std::shared_ptr<MappedFile>>::failure(FsStatus::IoError, path);
+    }
+    return FsResult<std::shared_ptr<MappedFile>>::success(std::shared_ptr<MappedFile>(new MappedFile(address, length)));
+}
+
+static bool rangeFits(std::uint64_t offset, std::uint64_t length, std::uint64_t limit)
+{
+    return offset <= limit && length <= limit - offset;
+}
+
+static std::int64_t toSnapshotTime(Timestamp time)
+{
+    return time.time_since_epoch().count();
+}
+
+static Timestamp fromSnapshotTime(std::int64_t time)
+{
+    return Timestamp(std::chrono::nanoseconds(time));
+}
+
+bool syncToDisk(const std::string &path)
+{
+    int descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (descriptor < 0)
+    {
+        return false;
+    }
+    bool synced = ::fsync(descriptor) == 0;
+    ::close(descriptor);
+    return synced;
+}
+
+FsResult<std::size_t> writeSnapshot(Directory &root, const std::string &path)
+{
+    std::vector<FileSystemComponent *> nodes{&root};
+    std::vector<std::uint64_t> parents{0};
+    std::uint64_t stringPoolSize = root.getNameView().size();
+    std::uint64_t contentSize = 0;
+    if (!isValidNodeName(root.getNameView()))
+    {
+        return FsResult<std::size_t>::failure(FsStatus::InvalidArgument, root.getName());
+    }
+    for (std::size_t index = 0; index < nodes.size(); ++index)
+    {
+        const Directory *directory = asDirectory(nodes[index]);
+        if (directory == nullptr)
+        {
+            continue;
+        }
+        for (auto &child : directory->getChildren())
+        {
+            // Checked with the same rule readSnapshot applies, so nothing is written that could not be loaded back.
+            if (!isValidNodeName(child.first))
+            {
+                return FsResult<std::size_t>::failure(FsStatus::InvalidArgument, std::string(child.first));
+            }
+            nodes.push_back(child.second.get());
+            parents.push_back(index);
+            stringPoolSize += child.first.size();
+            if (const File *file = asFile(child.second.get()))
+            {
+                contentSize += file->getSize();
+            }
+        }
+    }
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SnapshotHeader::expectedMagic, sizeof(header.magic));
+    header.version = SnapshotHeader::currentVersion;
+    header.byteOrder = SnapshotHeader::nativeByteOrder;
+    header.nodeCount = nodes.size();
+    header.nodeTableOffset = sizeof(SnapshotHeader);
+    header.stringPoolOffset = header.nodeTableOffset + nodes.size() * sizeof(SnapshotNode);
+    header.stringPoolSize = stringPoolSize;
+    header.contentOffset = header.stringPoolOffset + stringPoolSize;
+    header.contentSize = contentSize;
+
+    std::string temporaryPath = path + ".tmp";
+    std::ofstream output(temporaryPath, std::ios::binary | std::ios::trunc);
+    output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    std::uint64_t nameOffset = 0;
+    std::uint64_t contentOffset = 0;
+    for (std::size_t index = 0; index < nodes.size(); ++index)
+    {
+        SnapshotNode node{};
+        node.parentIndex = parents[index];
+        node.nameOffset = nameOffset;
+        node.nameLength = static_cast<std::uint32_t>(nodes[index]->getNameView().size());
+        node.kind = nodes[index]->getKind();
+        node.creationTime = toSnapshotTime(nodes[index]->getCreationTime());
+        node.modificationTime = toSnapshotTime(nodes[index]->getModificationTime());
+        if (const File *file = asFile(nodes[index]))
+        {
+            node.contentOffset = contentOffset;
+            node.contentLength = file->getSize();
+            contentOffset += file->getSize();
+        }
+        nameOffset += node.nameLength;
+        output.write(reinterpret_cast<const char *>(&node), sizeof(node));
+    }
+    for (FileSystemComponent *node : nodes)
+    {
+        std::string_view name = node->getNameView();
+        output.write(name.data(), name.size());
+    }
+    for (FileSystemComponent *node : nodes)
+    {
+        if (const File *file = asFile(node))
+        {
+            file->getFileContent().forEachChunk([&output](std::string_view chunk)
+                                                { output.write(chunk.data(), chunk.size()); });
+        }
+    }
+    output.close();
+    if (!output || !syncToDisk(temporaryPath) || std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+    {
+        std::remove(temporaryPath.c_str());
+        return FsResult<std::size_t>::failure(FsStatus::IoError, path);
+    }
+    return FsResult<std::size_t>::success(nodes.size());
+}
+
+FsResult<std::shared_ptr<Directory>> readSnapshot(const std::string &path, FileSystem &fileSystem)
+{
+    using Result = FsResult<std::shared_ptr<Directory>>;
+    FsResult<std::shared_ptr<MappedFile>> mapping = MappedFile::open(path);
+    if (!mapping.ok())
+    {
+        return Result::failure(mapping.status, std::move(mapping.detail));
+    }
+    std::string_view bytes = mapping.value->bytes();
+    SnapshotHeader header;
+    if (bytes.size() < sizeof(header))
+    {
+        return Result::failure(FsStatus::CorruptData, path);
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic, SnapshotHeader::expectedMagic, sizeof(header.magic)) != 0 || header.version != SnapshotHeader::currentVersion ||
+        header.byteOrder != SnapshotHeader::nativeByteOrder || header.nodeCount == 0 || header.nodeCount > bytes.size() / sizeof(SnapshotNode) ||
+        !rangeFits(header.nodeTableOffset, header.nodeCount * sizeof(SnapshotNode), bytes.size()) ||
+        !rangeFits(header.stringPoolOffset, header.stringPoolSize, bytes.size()) || !rangeFits(header.contentOffset, header.contentSize, bytes.size()))
+    {
+        return Result::failure(FsStatus::CorruptData, path);
+    }
+
+    std::string_view stringPool = bytes.substr(header.stringPoolOffset, header.stringPoolSize);
+    std::string_view contentRegion = bytes.substr(header.contentOffset, header.contentSize);
+    std::shared_ptr<const void> mappingOwner = mapping.value;
+    std::vector<Directory *> directories(header.nodeCount, nullptr);
+    std::shared_ptr<Directory> root;
+    for (std::uint64_t index = 0; index < header.nodeCount; ++index)
+    {
+        SnapshotNode node;
+        std::memcpy(&node, bytes.data() + header.nodeTableOffset + index * sizeof(SnapshotNode), sizeof(node));
+        bool validKind = node.kind == NodeKind::File || node.kind == NodeKind::Directory;
+        Directory *parent = index == 0 ? nullptr : node.parentIndex < index ? directories[node.parentIndex] : nullptr;
+        if (!validKind || !rangeFits(node.nameOffset, node.nameLength, stringPool.size()) || node.nameLength == 0 || (index != 0 && parent == nullptr) ||
+            (index == 0 && node.kind != NodeKind::Directory))
+        {
+            return Result::failure(FsStatus::CorruptData, path);
+        }
+        std::string name(stringPool.substr(node.nameOffset, node.nameLength));
+        if (!isValidNodeName(name) || (parent != nullptr && parent->findChild(name) != nullptr))
+        {
+            return Result::failure(FsStatus::CorruptData, path);
+        }
+        std::shared_ptr<FileSystemComponent> component;
+        if (node.kind == NodeKind::Directory)
+        {
+            std::shared_ptr<Directory> directory = fileSystem.makeDirectory(name);
+            directories[index] = directory.get();
+            component = directory;
+            if (index == 0)
+            {
+                root = directory;
+            }
+        }
+        else
+        {
+            if (!rangeFits(node.contentOffset, node.contentLength, contentRegion.size()))
+            {
+                return Result::failure(FsStatus::CorruptData, path);
+            }
+            std::shared_ptr<File> file = fileSystem.makeFile(name);
+            file->mapContent(contentRegion.substr(node.contentOffset, node.contentLength), mappingOwner);
+            component = file;
+        }
+        component->restoreTimes(fromSnapshotTime(node.creationTime), fromSnapshotTime(node.modificationTime));
+        if (parent != nullptr)
+        {
+            parent->addChild(component);
+        }
+    }
+    return Result::success(std::move(root));
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <vector>
+
+#include "subtreeReclaimer.hpp"
+#include "directory.hpp"
+#include "file.hpp"
+
+SubtreeReclaimer::~SubtreeReclaimer()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+        jobQueued.notify_all();
+    }
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+std::size_t SubtreeReclaimer::reclaim(std::shared_ptr<FileSystemComponent> root, TreeContext *context)
+{
+    std::vector<std::shared_ptr<FileSystemComponent>> nodes{std::move(root)};
+    std::vector<File *> files;
+    for (std::size_t index = 0; index < nodes.size(); ++index)
+    {
+        if (File *file = asFile(nodes[index].get()))
+        {
+            files.push_back(file);
+        }
+        else if (Directory *directory = asDirectory(nodes[index].get()))
+        {
+            directory->takeChildren(nodes);
+        }
+    }
+    for (std::size_t batchStart = 0; context != nullptr && batchStart < files.size(); batchStart += indexBatchSize)
+    {
+        std::unique_lock<std::shared_mutex> indexLock(context->indexMutex);
+        for (std::size_t index = batchStart; index < std::min(files.size(), batchStart + indexBatchSize); ++index)
+        {
+            context->nameIndex.removeSubtree(files[index]);
+            context->timeIndex.removeSubtree(files[index]);
+            if (context->contentIndex != nullptr)
+            {
+                context->contentIndex->removeSubtree(files[index]);
+            }
+        }
+    }
+    for (auto &node : nodes)
+    {
+        node->setParent(nullptr);
+    }
+    std::size_t nodeCount = nodes.size();
+    // Children were taken out of every directory, so each node is released without recursing into its subtree.
+    nodes.clear();
+    return nodeCount;
+}
+
+void SubtreeReclaimer::submit(std::shared_ptr<FileSystemComponent> root, std::shared_ptr<TreeContext> context)
+{
+    std::lock_guard<std::mutex> lock(queueMutex);
+    pendingJobs.push_back(Job{std::move(root), std::move(context)});
+    if (!worker.joinable())
+    {
+        worker = std::thread(&SubtreeReclaimer::runWorker, this);
+    }
+    jobQueued.notify_one();
+}
+
+void SubtreeReclaimer::drain()
+{
+    std::unique_lock<std::mutex> lock(queueMutex);
+    jobsFinished.wait(lock, [this]()
+                      { return pendingJobs.empty() && !working; });
+}
+
+std::size_t SubtreeReclaimer::getReclaimedNodeCount()
+{
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return reclaimedNodes;
+}
+
+void SubtreeReclaimer::runWorker()
+{
+    std::unique_lock<std::mutex> lock(queueMutex);
+    while (true)
+    {
+        jobQueued.wait(lock, [this]()
+                       { return stopping || !pendingJobs.empty(); });
+        if (pendingJobs.empty())
+        {
+            return;
+        }
+        Job job = std::move(pendingJobs.front());
+        pendingJobs.pop_front();
+        working = true;
+        lock.unlock();
+        std::size_t nodeCount = reclaim(std::move(job.root), job.context.get());
+        job.context.reset();
+        lock.lock();
+        working = false;
+        reclaimedNodes += nodeCount;
+        if (pendingJobs.empty())
+        {
+            jobsFinished.notify_all();
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#include "timeIndex.hpp"
+#include "directory.hpp"
+#include "file.hpp"
+
+void TimeIndex::addSubtree(FileSystemComponent *component)
+{
+    if (File *file = asFile(component))
+    {
+        Shard &shard = shardFor(file);
+        std::lock_guard<std::mutex> shardLock(shard.mutex);
+        shard.filesByModificationTime.emplace(file->getModificationTime(), file);
+    }
+    else if (Directory *directory = asDirectory(component))
+    {
+        for (auto &child : directory->getChildren())
+        {
+            addSubtree(child.second.get());
+        }
+    }
+}
+
+void TimeIndex::removeSubtree(FileSystemComponent *component)
+{
+    if (File *file = asFile(component))
+    {
+        Shard &shard = shardFor(file);
+        std::lock_guard<std::mutex> shardLock(shard.mutex);
+        shard.filesByModificationTime.erase({file->getModificationTime(), file});
+    }
+    else if (Directory *directory = asDirectory(component))
+    {
+        for (auto &child : directory->getChildren())
+        {
+            removeSubtree(child.second.get());
+        }
+    }
+}
+
+void TimeIndex::update(File *file, Timestamp previousTime, Timestamp currentTime)
+{
+    Shard &shard = shardFor(file);
+    std::lock_guard<std::mutex> shardLock(shard.mutex);
+    if (shard.filesByModificationTime.erase({previousTime, file}) != 0)
+    {
+        shard.filesByModificationTime.emplace(currentTime, file);
+    }
+}
+
+std::size_t TimeIndex::getIndexedFileCount() const
+{
+    std::size_t count = 0;
+    for (const Shard &shard : shards)
+    {
+        std::lock_guard<std::mutex> shardLock(shard.mutex);
+        count += shard.filesByModificationTime.size();
+    }
+    return count;
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "workStealingPool.hpp"
+
+static thread_local int workerIndexOfThread = -1;
+
+WorkStealingPool::WorkStealingPool(std::size_t threadCount)
+{
+    if (threadCount == 0)
+    {
+        threadCount = 1;
+    }
+    for (std::size_t index = 0; index < threadCount; ++index)
+    {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (std::size_t index = 0; index < threadCount; ++index)
+    {
+        workers.emplace_back(&WorkStealingPool::workerLoop, this, index);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeWorkers.notify_all();
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+int WorkStealingPool::currentWorker()
+{
+    return workerIndexOfThread;
+}
+
+void WorkStealingPool::submit(Task task)
+{
+    std::size_t queueIndex = workerIndexOfThread >= 0 ? static_cast<std::size_t>(workerIndexOfThread) : nextQueue++ % queues.size();
+    pendingTasks++;
+    queuedTasks++;
+    {
+        std::lock_guard<std::mutex> lock(queues[queueIndex]->queueMutex);
+        queues[queueIndex]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wakeWorkers.notify_one();
+}
+
+void WorkStealingPool::wait()
+{
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    allTasksDone.wait(lock, [this]
+                      { return pendingTasks == 0; });
+}
+
+bool WorkStealingPool::popLocal(std::size_t workerIndex, Task &task)
+{
+    WorkerQueue &queue = *queues[workerIndex];
+    std::lock_guard<std::mutex> lock(queue.queueMutex);
+    if (queue.tasks.empty())
+    {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(std::size_t workerIndex, Task &task)
+{
+    for (std::size_t offset = 1; offset < queues.size(); ++offset)
+    {
+        WorkerQueue &queue = *queues[(workerIndex + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.queueMutex);
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(std::size_t workerIndex)
+{
+    workerIndexOfThread = static_cast<int>(workerIndex);
+    Task task;
+    while (true)
+    {
+        if (popLocal(workerIndex, task) || steal(workerIndex, task))
+        {
+            queuedTasks--;
+            task();
+            task = nullptr;
+            if (--pendingTasks == 0)
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+                allTasksDone.notify_all();
+            }
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeWorkers.wait(lock, [this]
+                         { return stopping || queuedTasks > 0; });
+        if (stopping && queuedTasks == 0)
+        {
+            return;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,218 @@
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <thread>
+
+#include "workload.hpp"
+
+std::uint64_t SeededRandom::next()
+{
+    std::uint64_t mixed = (state += 0x9e3779b97f4a7c15ull);
+    mixed = (mixed ^ (mixed >> 30)) * 0xbf58476d1ce4e5b9ull;
+    mixed = (mixed ^ (mixed >> 27)) * 0x94d049bb133111ebull;
+    return mixed ^ (mixed >> 31);
+}
+
+std::uint64_t SeededRandom::uniform(std::uint64_t low, std::uint64_t high)
+{
+    if (high <= low)
+    {
+        return low;
+    }
+    return low + next() % (high - low + 1);
+}
+
+double SeededRandom::unit()
+{
+    return static_cast<double>(next() >> 11) * 0x1.0p-53;
+}
+
+double SeededRandom::exponential(double mean)
+{
+    return -std::log(1.0 - unit()) * mean;
+}
+
+std::uint64_t Distribution::sample(SeededRandom &random) const
+{
+    switch (kind)
+    {
+    case DistributionKind::Uniform:
+        return random.uniform(low, high);
+    case DistributionKind::Exponential:
+        return std::min(high, static_cast<std::uint64_t>(random.exponential(static_cast<double>(low))));
+    case DistributionKind::Fixed:
+        break;
+    }
+    return low;
+}
+
+static std::string expandPattern(const std::string &pattern, std::uint64_t number)
+{
+    std::string expanded = pattern;
+    std::size_t placeholder = expanded.find("{n}");
+    if (placeholder == std::string::npos)
+    {
+        return expanded + std::to_string(number);
+    }
+    return expanded.replace(placeholder, 3, std::to_string(number));
+}
+
+static std::string makeContent(SeededRandom &random, std::uint64_t size)
+{
+    std::string content;
+    content.reserve(size);
+    while (content.size() < size)
+    {
+        content += "INFO request " + std::to_string(random.uniform(0, 99999)) + " served by worker-" + std::to_string(random.uniform(0, 15)) + "\n";
+    }
+    content.resize(size);
+    return content;
+}
+
+GeneratedTree generateTree(FileSystem &fileSystem, const TreeShape &shape)
+{
+    SeededRandom random(shape.seed);
+    GeneratedTree tree;
+    std::deque<std::pair<std::string, int>> pending{{"", 0}};
+    std::size_t nodeCount = 0;
+    while (!pending.empty() && nodeCount < shape.maxNodes)
+    {
+        auto [parentPath, level] = pending.front();
+        pending.pop_front();
+        std::uint64_t fileCount = shape.filesPerDirectory.sample(random);
+        for (std::uint64_t index = 0; index < fileCount && nodeCount < shape.maxNodes; ++index, ++nodeCount)
+        {
+            std::string path = parentPath + "/" + expandPattern(shape.filePattern, index);
+            if (!fileSystem.createFileAt(path).ok())
+            {
+                continue;
+            }
+            std::uint64_t size = shape.fileSize.sample(random);
+            if (size != 0)
+            {
+                fileSystem.appendToFile(path, makeContent(random, size));
+                tree.contentBytes += size;
+            }
+            tree.files.push_back(std::move(path));
+        }
+        if (level >= shape.depth)
+        {
+            continue;
+        }
+        std::uint64_t directoryCount = shape.directoriesPerDirectory.sample(random);
+        for (std::uint64_t index = 0; index < directoryCount && nodeCount < shape.maxNodes; ++index, ++nodeCount)
+        {
+            std::string path = parentPath + "/" + expandPattern(shape.directoryPattern, index);
+            if (fileSystem.createDirectories(path).ok())
+            {
+                tree.directories.push_back(path);
+                pending.emplace_back(std::move(path), level + 1);
+            }
+        }
+    }
+    return tree;
+}
+
+std::string generateWorkload(const GeneratedTree &tree, const WorkloadMix &mix, std::size_t commandCount, std::uint64_t seed)
+{
+    SeededRandom random(seed);
+    const unsigned weights[] = {mix.cd, mix.ls, mix.cat, mix.find, mix.echo, mix.rm};
+    unsigned totalWeight = 0;
+    for (unsigned weight : weights)
+    {
+        totalWeight += weight;
+    }
+    auto pick = [&random](const std::vector<std::string> &paths)
+    { return paths.empty() ? std::string("/") : paths[random.uniform(0, paths.size() - 1)]; };
+    std::string script;
+    for (std::size_t command = 0; command < commandCount && totalWeight != 0; ++command)
+    {
+        std::uint64_t roll = random.uniform(0, totalWeight - 1);
+        std::size_t choice = 0;
+        while (roll >= weights[choice])
+        {
+            roll -= weights[choice++];
+        }
+        switch (choice)
+        {
+        case 0:
+            script += "cd " + pick(tree.directories) + "\n";
+            break;
+        case 1:
+            script += "ls\n";
+            break;
+        case 2:
+            script += "cat " + pick(tree.files) + "\n";
+            break;
+        case 3:
+        {
+            std::string file = pick(tree.files);
+            script += random.uniform(0, 3) == 0 ? "find -content worker-" + std::to_string(random.uniform(0, 15)) + "\n" : "find -file / " + file.substr(file.rfind('/') + 1) + "\n";
+            break;
+        }
+        case 4:
+            script += "echo " + pick(tree.files) + "\nINFO appended by replay " + std::to_string(command) + "\nexit\n";
+            break;
+        default:
+            script += "rm " + pick(tree.files) + "\n";
+            break;
+        }
+    }
+    return script;
+}
+
+double ReplayReport::throughput() const
+{
+    return elapsed.count() == 0 ? 0.0 : static_cast<double>(commands) * 1e9 / static_cast<double>(elapsed.count());
+}
+
+ReplayReport replayWorkload(CommandExecutor &commandExecutor, const CommandScript &script, double arrivalRate, std::uint64_t seed)
+{
+    using Clock = std::chrono::steady_clock;
+    SeededRandom random(seed);
+    const std::vector<ScriptInstruction> &instructions = script.getInstructions();
+    std::vector<std::chrono::nanoseconds> latencies;
+    latencies.reserve(instructions.size());
+    Clock::time_point started = Clock::now();
+    Clock::time_point intended = started;
+    for (const ScriptInstruction &instruction : instructions)
+    {
+        if (arrivalRate > 0)
+        {
+            intended += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(random.exponential(1.0 / arrivalRate)));
+            // Sleeping overshoots by tens of microseconds, so sleep short of the arrival and spin the rest.
+            if (intended - Clock::now() > std::chrono::microseconds(200))
+            {
+                std::this_thread::sleep_until(intended - std::chrono::microseconds(200));
+            }
+            while (Clock::now() < intended)
+            {
+            }
+        }
+        else
+        {
+            intended = Clock::now();
+        }
+        commandExecutor.executeInstruction(script, instruction);
+        latencies.push_back(Clock::now() - intended);
+    }
+
+    ReplayReport report;
+    report.commands = latencies.size();
+    report.elapsed = Clock::now() - started;
+    if (latencies.empty())
+    {
+        return report;
+    }
+    auto percentile = [&latencies](std::size_t perMille)
+    {
+        auto position = latencies.begin() + static_cast<std::ptrdiff_t>((latencies.size() - 1) * perMille / 1000);
+        std::nth_element(latencies.begin(), position, latencies.end());
+        return *position;
+    };
+    report.p50 = percentile(500);
+    report.p99 = percentile(990);
+    report.p999 = percentile(999);
+    report.maximum = *std::max_element(latencies.begin(), latencies.end());
+    return report;
+}
\ No newline at end of file
@@ -1,11 +1,18 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
 
 using ::testing::_;
 using ::testing::AtLeast;
 using ::testing::Return;
 
 #include "commandExecutor.hpp"
+#include "session.hpp"
+#include "workload.hpp"
 
 class TestFileClass : public ::testing::Test
 {
@@ -55,6 +62,13 @@ TEST_F(TestFileClass, getComponentTypeFunctionTest)
     EXPECT_EQ("File", file->getComponentType());
 }
 
+TEST_F(TestFileClass, nodeKindAndCheckedCastTest)
+{
+    EXPECT_EQ(NodeKind::File, file->getKind());
+    EXPECT_EQ(file, asFile(file));
+    EXPECT_EQ(nullptr, asDirectory(file));
+}
+
 TEST_F(TestFileClass, getTimestampFunctionTest)
 {
     auto currentTime = std::chrono::system_clock::now();
@@ -68,6 +82,70 @@ TEST_F(TestFileClass, getTimestampFunctionTest)
     EXPECT_EQ(minutesCount, fileminutesCount);
 }
 
+TEST(TestFileContent, appendsAcrossChunksWithoutLosingBytes)
+{
+    FileContent content;
+    std::string expected;
+    for (int index = 0; index < 2000; ++index)
+    {
+        std::string line = "line " + std::to_string(index) + "\n";
+        content.append(line);
+        expected += line;
+    }
+    EXPECT_GT(content.chunkCount(), 1u);
+    EXPECT_EQ(expected.size(), content.size());
+    EXPECT_EQ(expected, content.toString());
+    EXPECT_EQ(expected.substr(1000, 300), content.read(1000, 300));
+    EXPECT_EQ(expected.substr(expected.size() - 5), content.read(expected.size() - 5, 100));
+}
+
+TEST(TestFileContent, findsTextSpanningChunkBoundaries)
+{
+    FileContent content;
+    std::string expected;
+    for (int index = 0; index < 2000; ++index)
+    {
+        std::string line = "line " + std::to_string(index) + "\n";
+        content.append(line);
+        expected += line;
+    }
+    for (std::size_t boundary = 0, chunkIndex = 0; chunkIndex + 1 < content.chunkCount(); ++chunkIndex)
+    {
+        boundary += content.chunk(chunkIndex).size();
+        std::string needle = expected.substr(boundary - 3, 7);
+        EXPECT_EQ(expected.find(needle), content.find(needle));
+    }
+    EXPECT_EQ(FileContent::npos, content.find("line 2000"));
+}
+
+TEST(TestContentSearch, kernelsAgreeWithScalarSearch)
+{
+    std::string text;
+    for (int index = 0; index < 500; ++index)
+    {
+        text += "Record " + std::to_string(index * 7919 % 1000) + " status=ok; ";
+    }
+    text += "ERROR: disk Full at end";
+    std::vector<std::string> needles = {"ERROR", "status=ok; Record 9", "Full at end", "d", "missing needle", "at end"};
+    for (auto kernel : {SearchKernel::Scalar, SearchKernel::Sse2, SearchKernel::Avx2})
+    {
+        for (auto &needle : needles)
+        {
+            EXPECT_EQ(text.find(needle), findSubstring(text, needle, false, kernel)) << searchKernelName(kernel) << " " << needle;
+        }
+        EXPECT_EQ(text.find("ERROR: disk Full"), findSubstring(text, "error: DISK full", true, kernel)) << searchKernelName(kernel);
+        EXPECT_EQ(std::string::npos, findSubstring(text, "error: disk empty", true, kernel)) << searchKernelName(kernel);
+    }
+}
+
+TEST(TestContentSearch, matcherFindsAnyPattern)
+{
+    FileContent content;
+    content.append("first line\nSecond Line\n");
+    EXPECT_TRUE(ContentMatcher(std::vector<std::string>{"absent", "second line"}, true).matches(content));
+    EXPECT_FALSE(ContentMatcher(std::vector<std::string>{"absent", "second line"}).matches(content));
+}
+
 class TestDirectoryClass : public ::testing::Test
 {
 public:
@@ -128,6 +206,162 @@ TEST_F(TestDirectoryClass, removeEmptyChildFunctionTest)
     EXPECT_TRUE(directory->getSubDirectories().empty());
 }
 
+TEST_F(TestDirectoryClass, findChildFunctionTest)
+{
+    std::shared_ptr<File> file = std::make_shared<File>("sampleFile");
+    directory->addChild(file);
+    EXPECT_EQ(file.get(), directory->findChild("sampleFile"));
+    EXPECT_EQ(nullptr, directory->findChild("otherFile"));
+}
+
+TEST_F(TestDirectoryClass, iterateChildrenFunctionTest)
+{
+    directory->addChild(std::make_shared<File>("file1"));
+    directory->addChild(std::make_shared<Directory>("subDir"));
+    int childCount = 0;
+    for (auto &child : directory->getChildren())
+    {
+        EXPECT_EQ(child.first, child.second->getName());
+        ++childCount;
+    }
+    EXPECT_EQ(2, childCount);
+}
+
+TEST_F(TestDirectoryClass, addChildSetsParentTest)
+{
+    std::shared_ptr<Directory> subDirectory = std::make_shared<Directory>("subDir");
+    directory->addChild(subDirectory);
+    EXPECT_EQ(directory, subDirectory->getParent());
+    directory->removeChild("subDir");
+    EXPECT_EQ(nullptr, subDirectory->getParent());
+}
+
+TEST(TestChildTable, keepsEntriesSortedAcrossBlockSplits)
+{
+    ChildTable table;
+    std::vector<std::string> names;
+    for (int index = 0; index < 2000; ++index)
+    {
+        names.push_back("entry" + std::to_string((index * 7919) % 2000));
+        table.findOrInsert(names.back()) = std::make_shared<File>(names.back());
+    }
+    EXPECT_EQ(2000u, table.size());
+    EXPECT_GT(table.blockCount(), 1u);
+    std::sort(names.begin(), names.end());
+    std::vector<std::string> iterated;
+    for (auto &entry : table)
+    {
+        iterated.push_back(entry.first.str());
+    }
+    EXPECT_EQ(names, iterated);
+    EXPECT_EQ(names[1500], table.atOffset(1500)->first);
+
+    for (int index = 0; index < 2000; index += 2)
+    {
+        EXPECT_TRUE(table.erase(names[index]));
+    }
+    EXPECT_EQ(nullptr, table.find(names[0]));
+    ASSERT_NE(nullptr, table.find(names[1]));
+    auto [first, last] = table.prefixRange("entry19");
+    std::size_t expected = 0;
+    for (std::size_t index = 1; index < names.size(); index += 2)
+    {
+        expected += names[index].starts_with("entry19");
+    }
+    EXPECT_EQ(expected, static_cast<std::size_t>(std::distance(first, last)));
+}
+
+TEST(TestPathTokenizer, skipsEmptyAndCurrentSegments)
+{
+    PathTokenizer tokenizer("~//a/./b/");
+    std::vector<std::string> segments;
+    std::string_view segment;
+    while (tokenizer.next(segment))
+    {
+        segments.emplace_back(segment);
+    }
+    EXPECT_TRUE(tokenizer.isAbsolute());
+    EXPECT_EQ(segments, (std::vector<std::string>{"a", "b"}));
+}
+
+TEST(TestPathResolver, resolvesAndInvalidatesCachedPaths)
+{
+    std::shared_ptr<Directory> root = std::make_shared<Directory>("root");
+    root->setContext(std::make_shared<TreeContext>());
+    std::shared_ptr<Directory> subDirectory = std::make_shared<Directory>("sub");
+    root->addChild(subDirectory);
+    subDirectory->addChild(std::make_shared<File>("file"));
+
+    PathResolver resolver;
+    ResolvedPath resolved = resolver.resolve("sub/../sub/file", root.get(), root.get());
+    EXPECT_EQ(subDirectory->findChild("file"), resolved.component);
+    EXPECT_EQ(1u, resolver.cachedPaths());
+    EXPECT_EQ(resolved.component, resolver.resolve("sub/../sub/file", root.get(), root.get()).component);
+
+    subDirectory->removeChild("file");
+    resolved = resolver.resolve("sub/../sub/file", root.get(), root.get());
+    EXPECT_EQ(nullptr, resolved.component);
+    EXPECT_EQ("file", resolved.missingSegment);
+}
+
+TEST(TestPathResolver, rejectsDotLeavesOnCreate)
+{
+    FileSystem fileSystem;
+    Session session(fileSystem);
+    ASSERT_TRUE(fileSystem.createDirectories("a").ok());
+    for (const char *path : {".", "..", "a/.", "a/..", "/.."})
+    {
+        EXPECT_EQ(FsStatus::InvalidArgument, fileSystem.createFileAt(path).status) << path;
+        EXPECT_EQ(FsStatus::InvalidArgument, session.createFile(path).status) << path;
+    }
+    EXPECT_TRUE(fileSystem.createDirectories("a/../b/.").ok());
+    EXPECT_EQ((std::vector<std::string>{"a", "b"}), fileSystem.listDirectory().value);
+    EXPECT_TRUE(fileSystem.listDirectory("a").value.empty());
+}
+
+TEST(TestNodeArena, reusesFreedBlocks)
+{
+    NodeArena arena;
+    void *first = arena.allocate(48);
+    arena.deallocate(first, 48);
+    void *second = arena.allocate(40);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(1u, arena.getLiveAllocations());
+    arena.deallocate(second, 40);
+    EXPECT_EQ(0u, arena.getLiveAllocations());
+}
+
+TEST(TestNodeArena, fileSystemNodesComeFromArena)
+{
+    FileSystem fileSystem;
+    fileSystem.createDirectory("dir1");
+    std::size_t allocationsBefore = fileSystem.getNodeArena().getLiveAllocations();
+    fileSystem.createFile("dir1/file1");
+    std::size_t allocationsAfterCreate = fileSystem.getNodeArena().getLiveAllocations();
+    EXPECT_GT(allocationsAfterCreate, allocationsBefore);
+    fileSystem.changeDirectory("dir1");
+    fileSystem.removeFile("file1");
+    EXPECT_LT(fileSystem.getNodeArena().getLiveAllocations(), allocationsAfterCreate);
+}
+
+TEST(TestNodeArena, nodesMayOutliveTheirFileSystem)
+{
+    std::shared_ptr<Directory> keptRoot;
+    std::shared_ptr<FileSystemComponent> keptFile;
+    {
+        FileSystem fileSystem;
+        ASSERT_TRUE(fileSystem.createDirectories("a/b").ok());
+        ASSERT_TRUE(fileSystem.createFileAt("a/b/log").ok());
+        ASSERT_TRUE(fileSystem.appendToFile("a/b/log", "kept").ok());
+        keptRoot = fileSystem.getRootDirectory();
+        keptFile = fileSystem.resolveDirectory("a/b").value->getChild("log");
+    }
+    EXPECT_EQ("kept", asFile(keptFile.get())->getContent());
+    ASSERT_NE(nullptr, keptRoot->findChild("a"));
+    keptRoot.reset();
+    keptFile.reset();
+}
+
 class TestFileSystem : public ::testing::Test
 {
 public:
@@ -147,28 +381,18 @@ TEST_F(TestFileSystem, initializationCheck)
     ASSERT_EQ(fileSystemObject->getPathOfWorkingDirectory(), "~");
 }
 
-class MockFileSystemCreatingDirectory : public FileSystem
-{
-public:
-    MockFileSystemCreatingDirectory() : FileSystem() {}
-    MOCK_METHOD(std::vector<std::string>, splitPath, (std::istringstream &, const char &), (override));
-    // MOCK_METHOD(void, moveUpDirectory, (), (override));
-};
-
 TEST_F(TestFileSystem, creatingDirectoryFunctionTest)
 {
-    MockFileSystemCreatingDirectory mockdirectory;
-
-    EXPECT_CALL(mockdirectory, splitPath(_, _)).Times(1);
-    mockdirectory.createDirectory("subDirectory");
+    fileSystemObject->createDirectory("subDirectory");
+    fileSystemObject->changeDirectory("subDirectory");
+    EXPECT_EQ(fileSystemObject->getPathOfWorkingDirectory(), "~/subDirectory");
 }
 
 TEST_F(TestFileSystem, creatingDirectoryWithPathFunctionTest)
 {
-    MockFileSystemCreatingDirectory mockdirectory;
-
-    EXPECT_CALL(mockdirectory, splitPath(_, _)).Times(AtLeast(1));
-    mockdirectory.createDirectory("subDirectory/sampleDirectory");
+    fileSystemObject->createDirectory("subDirectory/sampleDirectory");
+    fileSystemObject->changeDirectory("subDirectory/sampleDirectory");
+    EXPECT_EQ(fileSystemObject->getPathOfWorkingDirectory(), "~/subDirectory/sampleDirectory");
 }
 
 class TestFileSystemChangeDirectory : public ::testing::Test
@@ -204,13 +428,14 @@ TEST_F(TestFileSystemChangeDirectory, changeDirectoryFunctionWithOneDirectory)
     EXPECT_EQ(fileSystemObject->getPathOfWorkingDirectory(), "~/sub1");
 }
 
-TEST_F(TestFileSystemChangeDirectory, changeDirectoryOneDirectoryPathCheckCallToSplitPath)
+TEST_F(TestFileSystemChangeDirectory, changeDirectoryNormalizesPath)
 {
-    MockFileSystemCreatingDirectory mockDirectory;
-    mockDirectory.createDirectory("sub1");
-
-    EXPECT_CALL(mockDirectory, splitPath(_, _)).Times(1);
-    mockDirectory.changeDirectory("sub1");
+    fileSystemObject->changeDirectory("sub1//./sub2/");
+    EXPECT_EQ(fileSystemObject->getPathOfWorkingDirectory(), "~/sub1/sub2");
+    fileSystemObject->changeDirectory("~/sub1");
+    EXPECT_EQ(fileSystemObject->getPathOfWorkingDirectory(), "~/sub1");
+    fileSystemObject->changeDirectory("/sub1/sub2");
+    EXPECT_EQ(fileSystemObject->getPathOfWorkingDirectory(), "~/sub1/sub2");
 }
 
 TEST_F(TestFileSystemChangeDirectory, changeDirectoryFunctionWIthMultipleDirectories)
@@ -241,6 +466,14 @@ TEST_F(TestFileSystemChangeDirectory, changeDirectoryPathMoveUpDirectory)
     EXPECT_EQ(fileSystemObject->getPathOfWorkingDirectory(), "~/sub1");
 }
 
+TEST_F(TestFileSystemChangeDirectory, changeDirectoryMoveUpAndDown)
+{
+    fileSystemObject->createDirectory("sub1/sub3/sub4");
+    fileSystemObject->changeDirectory("sub1/sub3/sub4");
+    fileSystemObject->changeDirectory("../../sub2");
+    EXPECT_EQ(fileSystemObject->getPathOfWorkingDirectory(), "~/sub1/sub2");
+}
+
 TEST_F(TestFileSystemChangeDirectory, moveUpOneDirectoryFunctionTest)
 {
     fileSystemObject->changeDirectory("sub1/sub2");
@@ -278,26 +511,20 @@ public:
     }
 };
 
-class MockFileSystemCreatingFile : public FileSystem
-{
-public:
-    MockFileSystemCreatingFile() : FileSystem() {}
-    MOCK_METHOD(std::vector<std::string>, splitPath, (std::istringstream &, const char &), (override));
-};
-
-TEST_F(TestFileSystemFile, creatingFileCallToSplitPath)
+TEST_F(TestFileSystemFile, creatingFileFunctionTest)
 {
-    MockFileSystemCreatingFile creatingFile;
-
-    EXPECT_CALL(creatingFile, splitPath(_, _)).Times(1);
-    creatingFile.createFile("file1");
+    fileSystemObject->createFile("file1");
+    fileSystemObject->displayFiles();
+    EXPECT_TRUE(mockcout.str().find("file1") != std::string::npos);
 }
 
 TEST_F(TestFileSystemFile, creatingFileWithinSubDirectory)
 {
-    MockFileSystemCreatingFile creatingFile;
-    EXPECT_CALL(creatingFile, splitPath(_, _)).Times(1);
-    creatingFile.createFile("sub1/file1");
+    fileSystemObject->createDirectory("sub1");
+    fileSystemObject->createFile("sub1/file1");
+    fileSystemObject->changeDirectory("sub1");
+    fileSystemObject->displayFiles();
+    EXPECT_TRUE(mockcout.str().find("file1") != std::string::npos);
 }
 
 TEST_F(TestFileSystemFile, creatingFileInUnknownDirectory)
@@ -365,7 +592,7 @@ TEST_F(TestFileSystemFile, displaySubDirectories)
     fileSystemObject->createDirectory("dir2");
 
     fileSystemObject->displayFiles();
-    EXPECT_TRUE(mockcout.str().find("dir2\nfile1\ndir1\n") != std::string::npos);
+    EXPECT_TRUE(mockcout.str().find("dir1\ndir2\nfile1\n") != std::string::npos);
 }
 
 TEST_F(TestFileSystemFile, callToRemoveChildFunction)
@@ -406,6 +633,16 @@ TEST_F(TestFileSystemFile, callToRemoveNonEmptyFile)
     EXPECT_TRUE(mockcout.str().find("Directory not empty") != std::string::npos);
 }
 
+TEST_F(TestFileSystemFile, callToRemoveDirectoryReportsEachFailure)
+{
+    fileSystemObject->createFile("plain");
+    fileSystemObject->removeDirectory("plain");
+    fileSystemObject->removeDirectory("..");
+    EXPECT_TRUE(mockcout.str().find("Not a directory: plain") != std::string::npos);
+    EXPECT_TRUE(mockcout.str().find("Invalid name: ..") != std::string::npos);
+    EXPECT_TRUE(mockcout.str().find("Directory not empty") == std::string::npos);
+}
+
 TEST_F(TestFileSystemFile, callToRemoveAllInputFileExtension)
 {
     fileSystemObject->createFile("file1.txt");
@@ -438,6 +675,693 @@ TEST_F(TestFileSystemFile, callToRemoveNonExistingFile)
     ASSERT_FALSE(mockcout.str().find("file2.txt") != std::string::npos);
 }
 
+TEST_F(TestFileSystemFile, findFileInParallelMatchesSerialFind)
+{
+    for (int directoryIndex = 0; directoryIndex < 8; ++directoryIndex)
+    {
+        std::string directory = "dir" + std::to_string(directoryIndex) + "/nested";
+        fileSystemObject->createDirectory(directory);
+        fileSystemObject->createFile(directory + "/target");
+        fileSystemObject->createFile(directory + "/other");
+    }
+    fileSystemObject->findFile("-file target");
+    std::vector<std::string> serialPaths;
+    std::string line;
+    while (std::getline(mockcout, line))
+    {
+        serialPaths.push_back(line);
+    }
+    std::sort(serialPaths.begin(), serialPaths.end());
+    mockcout.clear();
+    mockcout.str("");
+
+    fileSystemObject->findFile("-j 4 -file target");
+    EXPECT_EQ(4u, fileSystemObject->getFindThreadCount());
+    std::vector<std::string> parallelPaths;
+    while (std::getline(mockcout, line))
+    {
+        parallelPaths.push_back(line);
+    }
+    EXPECT_EQ(8u, parallelPaths.size());
+    EXPECT_EQ(serialPaths, parallelPaths);
+}
+
+TEST_F(TestFileSystemFile, removeSuffixPatternOnlyRemovesMatchingFiles)
+{
+    fileSystemObject->createFile("a.tmp");
+    fileSystemObject->createFile("b.tmp");
+    fileSystemObject->createFile("a.tmp.bak");
+    fileSystemObject->createDirectory("cache.tmp");
+
+    fileSystemObject->removeFile("*.tmp");
+    fileSystemObject->listFiles("*");
+    EXPECT_EQ("a.tmp.bak\ncache.tmp\n", mockcout.str());
+}
+
+TEST_F(TestFileSystemFile, listFilesWithCursors)
+{
+    for (char name = 'a'; name <= 'f'; ++name)
+    {
+        fileSystemObject->createFile(std::string(1, name) + ".txt");
+    }
+    fileSystemObject->listFiles("-offset 1 -limit 2");
+    EXPECT_EQ("b.txt\nc.txt\n", mockcout.str());
+    mockcout.str("");
+    fileSystemObject->listFiles("-after c.txt -limit 2");
+    EXPECT_EQ("d.txt\ne.txt\n", mockcout.str());
+    mockcout.str("");
+    fileSystemObject->listFiles("-offset 1 [a-e]*");
+    EXPECT_EQ("b.txt\nc.txt\nd.txt\ne.txt\n", mockcout.str());
+}
+
+TEST_F(TestFileSystemFile, findFileWithGlobPatterns)
+{
+    fileSystemObject->createDirectory("src/net");
+    fileSystemObject->createFile("src/main.cpp");
+    fileSystemObject->createFile("src/net/socket.cpp");
+    fileSystemObject->createFile("src/net/socket.hpp");
+
+    fileSystemObject->findFile("-file s?cket.[ch]pp");
+    EXPECT_EQ("~/src/net/socket.cpp\n~/src/net/socket.hpp\n", mockcout.str());
+    mockcout.str("");
+    fileSystemObject->findFile("-file src/**/*.cpp");
+    EXPECT_EQ("~/src/main.cpp\n~/src/net/socket.cpp\n", mockcout.str());
+}
+
+TEST(TestGlobPattern, matchesWildcardsAndClasses)
+{
+    EXPECT_TRUE(GlobPattern("*.log").matches("app.log"));
+    EXPECT_FALSE(GlobPattern("*.log").matches("app.log.1"));
+    EXPECT_TRUE(GlobPattern("file?.[0-9]").matches("file1.7"));
+    EXPECT_FALSE(GlobPattern("file[!1].txt").matches("file1.txt"));
+    EXPECT_FALSE(GlobPattern("*.cpp").matches("src/a.cpp"));
+    EXPECT_TRUE(GlobPattern("src/**/*.cpp").matches("src/a.cpp"));
+    EXPECT_TRUE(GlobPattern("src/**/*.cpp").matches("src/x/y/a.cpp"));
+    EXPECT_FALSE(GlobPattern("**/a.cpp").matches("xa.cpp"));
+    EXPECT_TRUE(GlobPattern("*.tar.gz").isSuffixPattern());
+    EXPECT_TRUE(GlobPattern("name").isLiteral());
+}
+
+TEST(TestGlobPattern, escapedMetacharactersMatchLiterally)
+{
+    GlobPattern escaped("a\\*b");
+    EXPECT_TRUE(escaped.isLiteral());
+    EXPECT_TRUE(escaped.matches("a*b"));
+    EXPECT_FALSE(escaped.matches("axb"));
+
+    FileSystem fileSystem;
+    ASSERT_TRUE(fileSystem.createFileAt("a*b").ok());
+    ASSERT_TRUE(fileSystem.createFileAt("axb").ok());
+    std::vector<FileSystemComponent *> found = fileSystem.getRootDirectory()->findMatchingChildren(escaped);
+    ASSERT_EQ(1u, found.size());
+    EXPECT_EQ("a*b", found[0]->getNameView());
+}
+
+TEST(TestOutputSink, vectorSinkCollectsOperationOutput)
+{
+    FileSystem fileSystem;
+    std::shared_ptr<VectorSink> sink = std::make_shared<VectorSink>();
+    fileSystem.setOutputSink(sink);
+    fileSystem.createDirectory("docs");
+    fileSystem.createFile("docs/notes");
+    fileSystem.createFile("notes");
+    fileSystem.findFile("-file notes");
+    fileSystem.displayFileContent("missing");
+    EXPECT_EQ((std::vector<std::string>{"~/docs/notes", "~/notes", "File not found"}), sink->getLines());
+}
+
+TEST(TestOutputSink, fileDescriptorSinkWritesOnFlush)
+{
+    int pipeEnds[2];
+    ASSERT_EQ(0, pipe(pipeEnds));
+    {
+        FileDescriptorSink sink(pipeEnds[1]);
+        sink << "first" << '\n' << "second";
+    }
+    close(pipeEnds[1]);
+    char received[32] = {};
+    EXPECT_EQ(12, read(pipeEnds[0], received, sizeof(received)));
+    EXPECT_STREQ("first\nsecond", received);
+    close(pipeEnds[0]);
+}
+
+TEST(TestResultApi, reportsValuesAndStatusesWithoutOutput)
+{
+    FileSystem fileSystem;
+    std::shared_ptr<VectorSink> sink = std::make_shared<VectorSink>();
+    fileSystem.setOutputSink(sink);
+
+    FsResult<Directory *> directory = fileSystem.createDirectories("logs/old");
+    ASSERT_TRUE(directory.ok());
+    EXPECT_EQ("old", directory.value->getName());
+    ASSERT_TRUE(fileSystem.createFileAt("logs/app.log").ok());
+    ASSERT_TRUE(fileSystem.appendToFile("logs/app.log", "started").ok());
+    FsResult<const FileContent *> content = fileSystem.readFile("logs/app.log");
+    ASSERT_TRUE(content.ok());
+    EXPECT_EQ("started", content.value->toString());
+
+    FsResult<File *> missing = fileSystem.createFileAt("nowhere/file");
+    EXPECT_EQ(FsStatus::PathNotFound, missing.status);
+    EXPECT_EQ("nowhere", missing.detail);
+    EXPECT_EQ(FsStatus::NotAFile, fileSystem.readFile("logs/old").status);
+    EXPECT_EQ(FsStatus::DirectoryNotEmpty, fileSystem.deleteDirectory("logs").status);
+
+    EXPECT_EQ((std::vector<std::string>{"app.log", "old"}), fileSystem.listDirectory("logs").value);
+    FindQuery query;
+    query.kind = FindKind::Content;
+    query.pattern = "START";
+    query.ignoreCase = true;
+    EXPECT_EQ((std::vector<std::string>{"~/logs/app.log"}), fileSystem.find(query).value);
+
+    FsResult<std::size_t> removed = fileSystem.deleteFiles("logs/*.log");
+    ASSERT_TRUE(removed.ok());
+    EXPECT_EQ(1u, removed.value);
+    EXPECT_TRUE(fileSystem.deleteDirectory("logs/old").ok());
+    EXPECT_TRUE(sink->getLines().empty());
+}
+
+TEST(TestSession, keepsWorkingDirectoryPerSession)
+{
+    FileSystem fileSystem;
+    Session first(fileSystem);
+    Session second(fileSystem);
+
+    ASSERT_TRUE(first.createDirectory("a/b").ok());
+    ASSERT_TRUE(first.changeDirectory("a/b").ok());
+    EXPECT_EQ("~/a/b", first.getWorkingPath());
+    EXPECT_EQ("~", second.getWorkingPath());
+    ASSERT_TRUE(first.createFile("note").ok());
+    ASSERT_TRUE(first.appendToFile("note", "hello").ok());
+    EXPECT_EQ("hello", second.readFile("a/b/note").value);
+    EXPECT_EQ(FsStatus::NotADirectory, second.changeDirectory("a/b/note").status);
+    EXPECT_TRUE(first.changeDirectory("../../..").ok());
+    EXPECT_EQ("~", first.getWorkingPath());
+    EXPECT_EQ(FsStatus::DirectoryNotEmpty, second.removeDirectory("a/b").status);
+    EXPECT_EQ(1u, second.removeFiles("a/b/*").value);
+    EXPECT_TRUE(second.removeDirectory("a/b").ok());
+}
+
+TEST(TestSession, concurrentSessionsKeepTreeConsistent)
+{
+    FileSystem fileSystem;
+    ASSERT_TRUE(Session(fileSystem).createDirectory("shared").ok());
+    const int threadCount = 4;
+    const int filesPerThread = 200;
+    std::vector<std::thread> workers;
+    for (int worker = 0; worker < threadCount; ++worker)
+    {
+        workers.emplace_back([&fileSystem, worker]()
+                             {
+            Session session(fileSystem);
+            std::string own = "own" + std::to_string(worker);
+            session.createDirectory(own + "/deep");
+            for (int index = 0; index < filesPerThread; ++index)
+            {
+                std::string name = "f" + std::to_string(index);
+                session.createFile(own + "/" + name);
+                session.appendToFile(own + "/" + name, "x");
+                session.createFile("shared/w" + std::to_string(worker) + name);
+                session.appendToFile("shared/counter", "ignored");
+                session.readFile(own + "/" + name);
+                session.listDirectory("shared");
+            } });
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    Session reader(fileSystem);
+    EXPECT_EQ(static_cast<std::size_t>(threadCount * filesPerThread), reader.listDirectory("shared").value.size());
+    for (int worker = 0; worker < threadCount; ++worker)
+    {
+        std::string own = "own" + std::to_string(worker);
+        EXPECT_EQ(static_cast<std::size_t>(filesPerThread + 1), reader.listDirectory(own).value.size());
+        EXPECT_EQ("x", reader.readFile(own + "/f0").value);
+    }
+    FindQuery query;
+    query.pattern = "f1*";
+    EXPECT_EQ(static_cast<std::size_t>(threadCount * 111), reader.find(query).value.size());
+}
+
+TEST(TestChildSnapshot, copiesOnlyTouchedBlocks)
+{
+    ChildTable table;
+    for (int index = 0; index < 1000; ++index)
+    {
+        table.findOrInsert("n" + std::to_string(1000 + index)) = std::make_shared<File>("n");
+    }
+    ChildSnapshot snapshot(table);
+    EXPECT_EQ(1000u, snapshot.size());
+    std::shared_ptr<File> added = std::make_shared<File>("added");
+    std::unique_ptr<ChildSnapshot> withAdded = snapshot.withChild("n1500a", added);
+    std::unique_ptr<ChildSnapshot> withoutFirst = withAdded->withoutChild("n1000");
+    EXPECT_EQ(nullptr, snapshot.find("n1500a"));
+    EXPECT_EQ(added, withAdded->find("n1500a")->second);
+    EXPECT_EQ(snapshot.find("n1999"), withAdded->find("n1999"));
+    EXPECT_NE(nullptr, withAdded->find("n1000"));
+    EXPECT_EQ(nullptr, withoutFirst->find("n1000"));
+    EXPECT_EQ(1000u, withoutFirst->size());
+}
+
+TEST(TestEpochDomain, defersReclaimWhileReaderIsPinned)
+{
+    EpochDomain &domain = EpochDomain::instance();
+    domain.reclaim();
+    std::weak_ptr<File> watched;
+    {
+        EpochGuard guard;
+        std::shared_ptr<File> file = std::make_shared<File>("retired");
+        watched = file;
+        std::thread([&domain, file]()
+                    { domain.retire(new std::shared_ptr<File>(file)); domain.reclaim(); })
+            .join();
+        file.reset();
+        domain.reclaim();
+        EXPECT_FALSE(watched.expired());
+    }
+    domain.reclaim();
+    EXPECT_TRUE(watched.expired());
+}
+
+TEST(TestEpochDomain, reclaimsWhenLastGuardExits)
+{
+    EpochDomain &domain = EpochDomain::instance();
+    domain.reclaim();
+    std::shared_ptr<File> file = std::make_shared<File>("retired");
+    std::weak_ptr<File> watched = file;
+    {
+        EpochGuard guard;
+        domain.retire(new std::shared_ptr<File>(file));
+        file.reset();
+        EXPECT_FALSE(watched.expired());
+    }
+    EXPECT_TRUE(watched.expired());
+    EXPECT_EQ(0u, domain.pendingCount());
+}
+
+TEST(TestSession, lockFreeReadersSeeConsistentDirectories)
+{
+    FileSystem fileSystem;
+    Session writer(fileSystem);
+    ASSERT_TRUE(writer.createDirectory("docs").ok());
+    ASSERT_TRUE(writer.createFile("docs/stable").ok());
+    ASSERT_TRUE(writer.appendToFile("docs/stable", "kept").ok());
+    fileSystem.setLockFreeReads(true);
+    ASSERT_TRUE(writer.createDirectory("docs/later").ok());
+    EXPECT_TRUE(fileSystem.getRootDirectory()->findChild("docs")->isDirectory());
+
+    std::atomic<bool> done{false};
+    std::atomic<int> failedReads{0};
+    std::vector<std::thread> readers;
+    for (int reader = 0; reader < 3; ++reader)
+    {
+        readers.emplace_back([&]()
+                             {
+            Session session(fileSystem);
+            while (!done.load())
+            {
+                if (session.readFile("docs/stable").value != "kept" || !session.changeDirectory("docs/later").ok() || !session.changeDirectory("/").ok())
+                {
+                    ++failedReads;
+                }
+                session.readFile("docs/churn");
+            } });
+    }
+    for (int round = 0; round < 500; ++round)
+    {
+        writer.createFile("docs/churn");
+        writer.appendToFile("docs/churn", "x");
+        writer.createFile("docs/f" + std::to_string(round));
+        writer.removeFiles("docs/churn");
+    }
+    done = true;
+    for (auto &reader : readers)
+    {
+        reader.join();
+    }
+    EXPECT_EQ(0, failedReads.load());
+    EXPECT_EQ(502u, writer.listDirectory("docs").value.size());
+    EXPECT_TRUE(fileSystem.getRootDirectory()->hasLockFreeReads());
+}
+
+TEST(TestSnapshot, roundTripsTreeWithMappedContent)
+{
+    std::string path = testing::TempDir() + "vfs_snapshot_test.bin";
+    FileSystem original;
+    ASSERT_TRUE(original.createDirectories("src/lib").ok());
+    ASSERT_TRUE(original.createFileAt("src/lib/a.cpp").ok());
+    ASSERT_TRUE(original.appendToFile("src/lib/a.cpp", "int main() {}").ok());
+    ASSERT_TRUE(original.createFileAt("notes").ok());
+    Timestamp written = asFile(original.resolveDirectory("src/lib").value->findChild("a.cpp"))->getModificationTime();
+    FsResult<std::size_t> saved = original.saveSnapshotTo(path);
+    ASSERT_TRUE(saved.ok());
+    EXPECT_EQ(5u, saved.value);
+
+    FileSystem restored;
+    restored.createFileAt("discarded");
+    ASSERT_TRUE(restored.loadSnapshotFrom(path).ok());
+    EXPECT_EQ((std::vector<std::string>{"notes", "src"}), restored.listDirectory().value);
+    File *file = asFile(restored.resolveDirectory("src/lib").value->findChild("a.cpp"));
+    ASSERT_NE(nullptr, file);
+    EXPECT_TRUE(file->getFileContent().isMapped());
+    EXPECT_EQ("int main() {}", file->getContent());
+    EXPECT_EQ(written, file->getModificationTime());
+    FindQuery query;
+    query.pattern = "a.cpp";
+    EXPECT_EQ((std::vector<std::string>{"~/src/lib/a.cpp"}), restored.find(query).value);
+
+    ASSERT_TRUE(restored.appendToFile("src/lib/a.cpp", " // done").ok());
+    EXPECT_EQ("int main() {} // done", file->getContent());
+    std::remove(path.c_str());
+    EXPECT_EQ("int main() {} // done", file->getContent());
+}
+
+TEST(TestSnapshot, rejectsMissingAndCorruptFiles)
+{
+    std::string path = testing::TempDir() + "vfs_snapshot_corrupt.bin";
+    FileSystem fileSystem;
+    EXPECT_EQ(FsStatus::IoError, fileSystem.loadSnapshotFrom(path + ".missing").status);
+    {
+        std::ofstream corrupt(path, std::ios::binary);
+        corrupt << "VFSSNAP but not really a snapshot, just text long enough to cover a header";
+    }
+    EXPECT_EQ(FsStatus::CorruptData, fileSystem.loadSnapshotFrom(path).status);
+    ASSERT_TRUE(fileSystem.createFileAt("kept").ok());
+    ASSERT_TRUE(fileSystem.saveSnapshotTo(path).ok());
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    EXPECT_EQ(FsStatus::CorruptData, fileSystem.loadSnapshotFrom(path).status);
+    EXPECT_EQ((std::vector<std::string>{"kept"}), fileSystem.listDirectory().value);
+    std::remove(path.c_str());
+}
+
+TEST(TestSnapshot, refusesToWriteNamesItCannotRead)
+{
+    std::string path = testing::TempDir() + "vfs_snapshot_invalid.bin";
+    std::remove(path.c_str());
+    FileSystem fileSystem;
+    ASSERT_TRUE(fileSystem.createFileAt("kept").ok());
+    fileSystem.getRootDirectory()->addChild(std::make_shared<File>(".."));
+    FsResult<std::size_t> saved = fileSystem.saveSnapshotTo(path);
+    EXPECT_EQ(FsStatus::InvalidArgument, saved.status);
+    EXPECT_EQ("..", saved.detail);
+    EXPECT_FALSE(std::filesystem::exists(path));
+    EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+}
+
+TEST(TestJournal, replaysMutationsAfterRestart)
+{
+    std::string directory = testing::TempDir() + "vfs_journal_replay";
+    std::filesystem::remove_all(directory);
+    Timestamp written;
+    {
+        FileSystem fileSystem;
+        ASSERT_TRUE(fileSystem.openJournal(directory).ok());
+        fileSystem.createDirectory("logs/old");
+        fileSystem.createFile("logs/app.log");
+        fileSystem.appendToFile("logs/app.log", "hello");
+        fileSystem.createFile("logs/tmp.log");
+        fileSystem.removeFile("logs/tmp*");
+        fileSystem.removeDirectory("logs/old");
+        written = asFile(fileSystem.resolveDirectory("logs").value->findChild("app.log"))->getModificationTime();
+    }
+    FileSystem restored;
+    FsResult<std::size_t> replayed = restored.openJournal(directory);
+    ASSERT_TRUE(replayed.ok());
+    EXPECT_EQ(7u, replayed.value);
+    EXPECT_EQ((std::vector<std::string>{"app.log"}), restored.listDirectory("logs").value);
+    EXPECT_EQ("hello", restored.readFile("logs/app.log").value->toString());
+    EXPECT_EQ(written, asFile(restored.resolveDirectory("logs").value->findChild("app.log"))->getModificationTime());
+    std::filesystem::remove_all(directory);
+}
+
+TEST(TestJournal, journalsEveryDirectoryCreatedAlongAPath)
+{
+    std::string directory = testing::TempDir() + "vfs_journal_mkdir";
+    std::filesystem::remove_all(directory);
+    {
+        FileSystem fileSystem;
+        ASSERT_TRUE(fileSystem.openJournal(directory).ok());
+        ASSERT_TRUE(fileSystem.createDirectories("a/../b").ok());
+        ASSERT_TRUE(fileSystem.createFileAt("f").ok());
+        EXPECT_EQ(FsStatus::NotADirectory, fileSystem.createDirectories("m/../f/z").status);
+    }
+    FileSystem restored;
+    ASSERT_TRUE(restored.openJournal(directory).ok());
+    EXPECT_EQ((std::vector<std::string>{"a", "b", "f", "m"}), restored.listDirectory().value);
+    std::filesystem::remove_all(directory);
+}
+
+TEST(TestJournal, dropsTornTailAndCompactsIntoSnapshot)
+{
+    std::string directory = testing::TempDir() + "vfs_journal_compact";
+    std::filesystem::remove_all(directory);
+    JournalOptions options;
+    options.syncPolicy = SyncPolicy::Always;
+    {
+        FileSystem fileSystem;
+        ASSERT_TRUE(fileSystem.openJournal(directory, options).ok());
+        fileSystem.createFile("kept");
+    }
+    {
+        std::ofstream torn(directory + "/journal.0", std::ios::binary | std::ios::app);
+        torn << "\x30\x00\x00\x00partial";
+    }
+    options.compactionThreshold = 512;
+    {
+        FileSystem fileSystem;
+        ASSERT_EQ(1u, fileSystem.openJournal(directory, options).value);
+        for (int index = 0; index < 40; ++index)
+        {
+            fileSystem.createFile("f" + std::to_string(index));
+        }
+        fileSystem.appendToFile("kept", "after compaction");
+    }
+    EXPECT_FALSE(std::filesystem::exists(directory + "/journal.0"));
+    FileSystem restored;
+    ASSERT_TRUE(restored.openJournal(directory, options).ok());
+    EXPECT_EQ(41u, restored.listDirectory().value.size());
+    EXPECT_EQ("after compaction", restored.readFile("kept").value->toString());
+    std::filesystem::remove_all(directory);
+}
+
+TEST(TestJournal, failedCompactionKeepsOlderGenerations)
+{
+    std::string directory = testing::TempDir() + "vfs_journal_failed_compact";
+    std::filesystem::remove_all(directory);
+    JournalOptions options;
+    options.compactionThreshold = 256;
+    {
+        FileSystem fileSystem;
+        std::shared_ptr<VectorSink> sink = std::make_shared<VectorSink>();
+        fileSystem.setOutputSink(sink);
+        ASSERT_TRUE(fileSystem.openJournal(directory, options).ok());
+        fileSystem.getRootDirectory()->addChild(std::make_shared<File>("."));
+        for (int index = 0; index < 20; ++index)
+        {
+            ASSERT_TRUE(fileSystem.createFileAt("f" + std::to_string(index)).ok());
+        }
+        ASSERT_FALSE(sink->getLines().empty());
+        EXPECT_EQ("Cannot compact journal: . (invalid argument)", sink->getLines().front());
+    }
+    EXPECT_TRUE(std::filesystem::exists(directory + "/journal.0"));
+    FileSystem restored;
+    ASSERT_TRUE(restored.openJournal(directory, options).ok());
+    EXPECT_EQ(20u, restored.listDirectory().value.size());
+    std::filesystem::remove_all(directory);
+}
+
+TEST(TestJournal, groupCommitsConcurrentAppends)
+{
+    std::string path = testing::TempDir() + "vfs_group_commit.journal";
+    std::remove(path.c_str());
+    JournalOptions options;
+    options.syncPolicy = SyncPolicy::Always;
+    {
+        std::unique_ptr<Journal> journal = std::move(Journal::open(path, options).value);
+        std::vector<std::thread> writers;
+        for (int writer = 0; writer < 4; ++writer)
+        {
+            writers.emplace_back([&journal, writer]()
+                                 {
+                for (int index = 0; index < 50; ++index)
+                {
+                    journal->append(JournalRecord{JournalOperation::CreateFile, currentTimestamp(), "/w" + std::to_string(writer), {}});
+                } });
+        }
+        for (auto &writer : writers)
+        {
+            writer.join();
+        }
+    }
+    std::size_t seen = 0;
+    EXPECT_EQ(200u, Journal::replay(path, [&seen](const JournalRecord &)
+                                    { ++seen; })
+                        .value);
+    EXPECT_EQ(200u, seen);
+    std::remove(path.c_str());
+}
+
+TEST(TestWorkStealingPool, runsNestedTasks)
+{
+    WorkStealingPool pool(4);
+    std::atomic<int> taskCount{0};
+    std::function<void(int)> spawn = [&](int depth)
+    {
+        taskCount++;
+        if (depth < 6)
+        {
+            pool.submit([&spawn, depth]
+                        { spawn(depth + 1); });
+            pool.submit([&spawn, depth]
+                        { spawn(depth + 1); });
+        }
+    };
+    pool.submit([&spawn]
+                { spawn(0); });
+    pool.wait();
+    EXPECT_EQ(127, taskCount);
+}
+
+TEST_F(TestFileSystemFile, findFileByContentThroughIndex)
+{
+    fileSystemObject->setContentIndexEnabled(true);
+    fileSystemObject->createDirectory("logs/old");
+    fileSystemObject->createFile("logs/app.log");
+    fileSystemObject->createFile("logs/old/app.log");
+    fileSystemObject->createFile("notes");
+    mockcin << "request timeout after 30s\nexit\n";
+    fileSystemObject->writeToFile("logs/app.log");
+    mockcin << "all good\nexit\n";
+    fileSystemObject->writeToFile("logs/old/app.log");
+    mockcin << "Timeout is configurable\nexit\n";
+    fileSystemObject->writeToFile("notes");
+    mockcout.str("");
+
+    fileSystemObject->findFile("-content timeout");
+    EXPECT_EQ("~/logs/app.log\n", mockcout.str());
+    mockcout.str("");
+    fileSystemObject->findFile("-icontent timeout");
+    EXPECT_EQ("~/logs/app.log\n~/notes\n", mockcout.str());
+    mockcout.str("");
+    fileSystemObject->findFile("-icontent logs timeout");
+    EXPECT_EQ("~/logs/app.log\n", mockcout.str());
+
+    fileSystemObject->changeDirectory("logs");
+    fileSystemObject->removeFile("app.log");
+    mockcout.str("");
+    fileSystemObject->findFile("-content ~ timeout");
+    EXPECT_EQ("", mockcout.str());
+}
+
+TEST_F(TestFileSystemFile, findFileByNameAfterRemoval)
+{
+    fileSystemObject->createDirectory("dir1/dir2");
+    fileSystemObject->createFile("dir1/target");
+    fileSystemObject->createFile("dir1/dir2/target");
+    fileSystemObject->changeDirectory("dir1/dir2");
+    fileSystemObject->removeFile("target");
+    fileSystemObject->changeDirectory(" ");
+    mockcout.str("");
+
+    fileSystemObject->findFile("-file target");
+    EXPECT_EQ("~/dir1/target\n", mockcout.str());
+}
+
+TEST(TestNameIndex, tracksFilesAddedAndRemovedWithSubtrees)
+{
+    std::shared_ptr<Directory> root = std::make_shared<Directory>("root");
+    root->setContext(std::make_shared<TreeContext>());
+    std::shared_ptr<Directory> subDirectory = std::make_shared<Directory>("sub");
+    subDirectory->addChild(std::make_shared<File>("a.txt"));
+    subDirectory->addChild(std::make_shared<File>("b.txt"));
+    root->addChild(subDirectory);
+    root->addChild(std::make_shared<File>("a.txt"));
+
+    NameIndex &index = root->getContext()->nameIndex;
+    ASSERT_NE(nullptr, index.find("a.txt"));
+    EXPECT_EQ(2u, index.find("a.txt")->size());
+    EXPECT_EQ(3u, index.getIndexedFileCount());
+
+    root->removeChild("sub");
+    EXPECT_EQ(1u, index.find("a.txt")->size());
+    EXPECT_EQ(nullptr, index.find("b.txt"));
+    EXPECT_EQ(nullptr, subDirectory->getContext());
+}
+
+TEST(TestContentIndex, dropsPostingsForRemovedFiles)
+{
+    std::shared_ptr<Directory> root = std::make_shared<Directory>("root");
+    root->setContext(std::make_shared<TreeContext>());
+    root->getContext()->contentIndex = std::make_unique<ContentIndex>();
+    std::shared_ptr<File> file = std::make_shared<File>("file");
+    root->addChild(file);
+    file->setContent("abc");
+    file->setContent("def");
+    ContentIndex &index = *root->getContext()->contentIndex;
+    EXPECT_EQ(4u, index.getTrigramCount());
+    EXPECT_EQ(std::vector<File *>{file.get()}, index.findCandidates("cde"));
+    root->removeChild("file");
+    EXPECT_EQ(0u, index.getTrigramCount());
+}
+
+TEST(TestTimeIndex, ordersFilesByModificationTime)
+{
+    std::shared_ptr<Directory> root = std::make_shared<Directory>("root");
+    root->setContext(std::make_shared<TreeContext>());
+    std::shared_ptr<File> older = std::make_shared<File>("older");
+    std::shared_ptr<File> newer = std::make_shared<File>("newer");
+    root->addChild(older);
+    root->addChild(newer);
+    Timestamp createdAt = older->getModificationTime();
+
+    newer->setContent("text");
+    EXPECT_GE(newer->getModificationTime(), createdAt);
+    EXPECT_EQ(createdAt, older->getModificationTime());
+
+    std::vector<File *> modified;
+    root->getContext()->timeIndex.forEachModifiedSince(newer->getModificationTime(), [&](File *file)
+                                                       { modified.push_back(file); });
+    EXPECT_EQ(std::vector<File *>{newer.get()}, modified);
+
+    root->removeChild("newer");
+    EXPECT_EQ(1u, root->getContext()->timeIndex.getIndexedFileCount());
+}
+
+TEST(TestTimeIndex, concurrentAppendsKeepEveryFileIndexed)
+{
+    std::shared_ptr<Directory> root = std::make_shared<Directory>("root");
+    root->setContext(std::make_shared<TreeContext>());
+    std::vector<std::shared_ptr<File>> files;
+    for (int index = 0; index < 8; ++index)
+    {
+        files.push_back(std::make_shared<File>("file" + std::to_string(index)));
+        root->addChild(files.back());
+    }
+
+    std::vector<std::thread> writers;
+    for (std::shared_ptr<File> &file : files)
+    {
+        writers.emplace_back([&file]()
+                             {
+            for (int append = 0; append < 200; ++append)
+            {
+                file->setContent("x");
+            } });
+    }
+    for (std::thread &writer : writers)
+    {
+        writer.join();
+    }
+
+    std::size_t visited = 0;
+    root->getContext()->timeIndex.forEachModifiedSince(Timestamp{}, [&](File *)
+                                                       { ++visited; });
+    EXPECT_EQ(files.size(), visited);
+    EXPECT_EQ(files.size(), root->getContext()->timeIndex.getIndexedFileCount());
+    EXPECT_EQ(200u, files.front()->getContent().size());
+}
+
 class MockFileSystemFindingFile : public FileSystem
 {
 public:
@@ -446,6 +1370,17 @@ public:
     MOCK_METHOD(void, findByContent, (const std::string &, (const std::pair<std::string, std::shared_ptr<FileSystemComponent>> &), std::string), (override));
 };
 
+TEST_F(TestFileSystemFile, findFileInNestedDirectories)
+{
+    fileSystemObject->createDirectory("dir1/dir2");
+    fileSystemObject->createFile("dir1/dir2/file1");
+    fileSystemObject->createFile("file1");
+
+    fileSystemObject->findFile("-file file1");
+    EXPECT_TRUE(mockcout.str().find("~/dir1/dir2/file1\n") != std::string::npos);
+    EXPECT_TRUE(mockcout.str().find("~/file1\n") != std::string::npos);
+}
+
 TEST_F(TestFileSystemFile, findFileByFileName)
 {
     MockFileSystemFindingFile findingFile;
@@ -491,6 +1426,10 @@ public:
     MOCK_METHOD(void, removeDirectory, (const std::string &), (override));
     MOCK_METHOD(void, removeFile, (const std::string &), (override));
     MOCK_METHOD(void, findFile, (const std::string &), (override));
+    MOCK_METHOD(void, saveSnapshot, (const std::string &), (override));
+    MOCK_METHOD(void, loadSnapshot, (const std::string &), (override));
+    MOCK_METHOD(void, displayStats, (const std::string &), (override));
+    MOCK_METHOD(void, displayMemoryUsage, (const std::string &), (override));
 };
 
 class TestCommandExecutorClass : public ::testing::Test
@@ -566,6 +1505,26 @@ TEST_F(TestCommandExecutorClass, TestfindCommand)
     commandExecutor->handlefindFile();
 }
 
+TEST_F(TestCommandExecutorClass, TestsaveAndloadCommands)
+{
+    EXPECT_CALL(*mockFileSystem, saveSnapshot(_)).Times(1);
+    EXPECT_CALL(*mockFileSystem, loadSnapshot(_)).Times(1);
+    commandExecutor->handlesave();
+    commandExecutor->handleload();
+}
+
+TEST_F(TestCommandExecutorClass, TeststatsCommand)
+{
+    EXPECT_CALL(*mockFileSystem, displayStats(_)).Times(1);
+    commandExecutor->handlestats();
+}
+
+TEST_F(TestCommandExecutorClass, TestduCommand)
+{
+    EXPECT_CALL(*mockFileSystem, displayMemoryUsage(_)).Times(1);
+    commandExecutor->handledu();
+}
+
 class MockCommandParser : public CommandExecutor
 {
 public:
@@ -634,4 +1593,307 @@ TEST_F(TestCommandExecutorParsing, isCommandNameValidCommand)
 TEST_F(TestCommandExecutorParsing, isCommandNameInvalidCommand)
 {
     EXPECT_FALSE(commandExecutor->isCommandName("someCommand"));
+}
+
+TEST(TestCommandScript, parsesScriptIntoCompactInstructions)
+{
+    FsResult<CommandScript> parsed = CommandScript::parse("# setup\nmkdir logs\n\necho logs/app.log\nline one\nline two\nexit\nls\nfrobnicate x\nexit\ncd logs\n");
+    ASSERT_TRUE(parsed.ok());
+    const CommandScript &script = parsed.value;
+    const std::vector<ScriptInstruction> &instructions = script.getInstructions();
+    ASSERT_EQ(4u, instructions.size());
+    EXPECT_EQ(Opcode::MakeDirectory, instructions[0].opcode);
+    EXPECT_EQ("logs", script.argument(instructions[0]));
+    EXPECT_EQ(Opcode::Echo, instructions[1].opcode);
+    EXPECT_EQ("line one\nline two\n", script.text(instructions[1]));
+    EXPECT_EQ(Opcode::List, instructions[2].opcode);
+    EXPECT_EQ(" ", script.argument(instructions[2]));
+    EXPECT_EQ(Opcode::Unknown, instructions[3].opcode);
+}
+
+TEST(TestCommandScript, trimsCarriageReturnsFromEchoBodies)
+{
+    FsResult<CommandScript> parsed = CommandScript::parse("echo notes\r\nfirst\r\nsecond\r\nexit\r\nls\r\n");
+    ASSERT_TRUE(parsed.ok());
+    const std::vector<ScriptInstruction> &instructions = parsed.value.getInstructions();
+    ASSERT_EQ(2u, instructions.size());
+    EXPECT_EQ("notes", parsed.value.argument(instructions[0]));
+    EXPECT_EQ("first\nsecond\n", parsed.value.text(instructions[0]));
+    EXPECT_EQ(Opcode::List, instructions[1].opcode);
+}
+
+TEST(TestCommandScript, batchRunProducesOutputAndLatencySummary)
+{
+    std::shared_ptr<FileSystem> fileSystem = std::make_shared<FileSystem>();
+    std::shared_ptr<VectorSink> sink = std::make_shared<VectorSink>();
+    fileSystem->setOutputSink(sink);
+    CommandExecutor commandExecutor(fileSystem);
+    std::istringstream input("mkdir logs\ntouch logs/app.log\necho logs/app.log\nstarted\nexit\ncat logs/app.log\necho missing/app.log\nx\nexit\nbogus\n");
+    std::ostringstream summary;
+    commandExecutor.runBatch(input, summary);
+
+    EXPECT_EQ((std::vector<std::string>{"File Content", "started", "", "Directory not found:missing", "Command not found"}), sink->getLines());
+    EXPECT_EQ(sink.get(), &fileSystem->getOutputSink());
+    EXPECT_NE(std::string::npos, summary.str().find("echo             2"));
+    EXPECT_NE(std::string::npos, summary.str().find("unknown          1"));
+}
+
+TEST(TestWorkload, generatorIsReproducibleForASeed)
+{
+    TreeShape shape;
+    shape.seed = 42;
+    shape.depth = 3;
+    shape.fileSize = {DistributionKind::Uniform, 10, 100};
+    shape.filePattern = "log{n}.txt";
+    FileSystem first;
+    FileSystem second;
+    GeneratedTree firstTree = generateTree(first, shape);
+    GeneratedTree secondTree = generateTree(second, shape);
+    ASSERT_FALSE(firstTree.files.empty());
+    EXPECT_EQ(firstTree.directories, secondTree.directories);
+    EXPECT_EQ(firstTree.files, secondTree.files);
+    EXPECT_EQ(firstTree.contentBytes, secondTree.contentBytes);
+    for (const std::string &path : firstTree.files)
+    {
+        EXPECT_LE(std::count(path.begin(), path.end(), '/'), 4);
+        EXPECT_EQ(first.readFile(path).value->size(), second.readFile(path).value->size());
+    }
+    EXPECT_EQ(generateWorkload(firstTree, WorkloadMix{}, 200, 9), generateWorkload(secondTree, WorkloadMix{}, 200, 9));
+
+    shape.maxNodes = 10;
+    FileSystem capped;
+    GeneratedTree cappedTree = generateTree(capped, shape);
+    EXPECT_LE(cappedTree.directories.size() + cappedTree.files.size(), 10u);
+}
+
+TEST(TestWorkload, replayerRunsEveryCommand)
+{
+    std::shared_ptr<FileSystem> fileSystem = std::make_shared<FileSystem>();
+    fileSystem->setOutputSink(std::make_shared<DiscardSink>());
+    GeneratedTree tree = generateTree(*fileSystem, TreeShape{});
+    CommandScript script = CommandScript::parse(generateWorkload(tree, WorkloadMix{}, 500, 3)).value;
+    CommandExecutor commandExecutor(fileSystem);
+    ReplayReport report = replayWorkload(commandExecutor, script, 0, 3);
+    EXPECT_EQ(500u, report.commands);
+    EXPECT_LE(report.p50, report.p99);
+    EXPECT_LE(report.p99, report.p999);
+    EXPECT_LE(report.p999, report.maximum);
+    EXPECT_GT(report.throughput(), 0.0);
+}
+
+TEST(TestInstrumentation, histogramBucketsKeepThreeSignificantBits)
+{
+    for (std::uint64_t value : {0ull, 7ull, 8ull, 9ull, 15ull, 16ull, 1000ull, 123456789ull, ~0ull})
+    {
+        std::size_t bucket = LatencyHistogram::bucketFor(value);
+        ASSERT_LT(bucket, LatencyHistogram::bucketCount);
+        EXPECT_GE(LatencyHistogram::bucketUpperBound(bucket), value);
+        EXPECT_LE(LatencyHistogram::bucketUpperBound(bucket) - value, value / 8);
+    }
+    EXPECT_LT(LatencyHistogram::bucketFor(1000), LatencyHistogram::bucketFor(1200));
+}
+
+TEST(TestInstrumentation, statsCommandReportsOperationsAndCounters)
+{
+    if (!Instrumentation::enabled)
+    {
+        GTEST_SKIP();
+    }
+    FileSystem fileSystem;
+    std::shared_ptr<VectorSink> sink = std::make_shared<VectorSink>();
+    fileSystem.setOutputSink(sink);
+    Instrumentation::instance().reset();
+    Instrumentation::setSamplingInterval(1);
+    ASSERT_FALSE(fileSystem.createFileAt("a/b").ok());
+    ASSERT_TRUE(fileSystem.createDirectories("a/b/c").ok());
+    ASSERT_TRUE(fileSystem.createFileAt("a/b/c/log").ok());
+    ASSERT_TRUE(fileSystem.appendToFile("a/b/c/log", "twelve bytes").ok());
+    FindQuery query;
+    query.kind = FindKind::ModifiedWithin;
+    query.range = std::chrono::hours(1);
+    ASSERT_TRUE(fileSystem.find(query).ok());
+
+    StatsSnapshot stats = Instrumentation::instance().snapshot();
+    EXPECT_EQ(2u, stats.operations[static_cast<std::size_t>(StatOperation::CreateFile)].count);
+    EXPECT_EQ(1u, stats.operations[static_cast<std::size_t>(StatOperation::Append)].count);
+    EXPECT_EQ(1u, stats.operations[static_cast<std::size_t>(StatOperation::Append)].samples);
+    EXPECT_EQ(1u, stats.operations[static_cast<std::size_t>(StatOperation::Find)].count);
+    EXPECT_EQ(12u, stats.counters[static_cast<std::size_t>(StatCounter::BytesAppended)]);
+    EXPECT_EQ(1u, stats.findVisits.count);
+    EXPECT_EQ(3u, stats.pathDepth.maximum);
+
+    fileSystem.displayStats("-json");
+    ASSERT_EQ(1u, sink->getLines().size());
+    EXPECT_NE(std::string::npos, sink->getLines()[0].find("\"append\":{\"count\":1,"));
+    Instrumentation::setSamplingInterval(16);
+    fileSystem.displayStats("-reset");
+    EXPECT_EQ(0u, Instrumentation::instance().snapshot().counters[static_cast<std::size_t>(StatCounter::BytesAppended)]);
+}
+
+TEST(TestInstrumentation, resetIsAppliedByEachOwningThread)
+{
+    if (!Instrumentation::enabled)
+    {
+        GTEST_SKIP();
+    }
+    Instrumentation &instrumentation = Instrumentation::instance();
+    auto bytesAppended = [&instrumentation]()
+    { return instrumentation.snapshot().counters[static_cast<std::size_t>(StatCounter::BytesAppended)]; };
+    instrumentation.reset();
+    std::thread([]()
+                { Instrumentation::count(StatCounter::BytesAppended, 5); })
+        .join();
+    EXPECT_EQ(5u, bytesAppended());
+
+    instrumentation.reset();
+    EXPECT_EQ(0u, bytesAppended());
+    std::thread([]()
+                { Instrumentation::count(StatCounter::BytesAppended, 7); })
+        .join();
+    EXPECT_EQ(7u, bytesAppended());
+}
+
+TEST(TestNodeName, shortNamesInlineAndLongNamesShareOneInternedCopy)
+{
+    static_assert(sizeof(NodeName) == 16);
+    NodeName shortName("fifteen_chars__");
+    EXPECT_FALSE(shortName.isInterned());
+    EXPECT_EQ("fifteen_chars__", shortName);
+
+    std::size_t internedBefore = NameInterner::instance().internedCount();
+    std::string longText = "a_name_that_does_not_fit_inline.txt";
+    {
+        NodeName first(longText);
+        NodeName second(longText);
+        NodeName copied = first;
+        EXPECT_TRUE(first.isInterned());
+        EXPECT_EQ(first.internedEntry(), second.internedEntry());
+        EXPECT_EQ(first.internedEntry(), copied.internedEntry());
+        EXPECT_EQ(internedBefore + 1, NameInterner::instance().internedCount());
+        NodeName moved = std::move(second);
+        EXPECT_EQ(longText, moved.str());
+        EXPECT_TRUE(second.empty());
+        EXPECT_LT(NodeName("a"), moved);
+    }
+    EXPECT_EQ(internedBefore, NameInterner::instance().internedCount());
+}
+
+TEST(TestMemoryReport, duCommandBreaksDownBytesPerNodeType)
+{
+    FileSystem fileSystem;
+    std::shared_ptr<VectorSink> sink = std::make_shared<VectorSink>();
+    fileSystem.setOutputSink(sink);
+    ASSERT_TRUE(fileSystem.createDirectories("a/b").ok());
+    ASSERT_TRUE(fileSystem.createFileAt("a/short.txt").ok());
+    ASSERT_TRUE(fileSystem.createFileAt("a/b/a_name_that_does_not_fit_inline.txt").ok());
+    ASSERT_TRUE(fileSystem.appendToFile("a/short.txt", "hello").ok());
+
+    FsResult<MemoryReport> report = fileSystem.measureMemoryAt("a");
+    ASSERT_TRUE(report.ok());
+    EXPECT_EQ(2u, report.value.files.count);
+    EXPECT_EQ(2u, report.value.directories.count);
+    EXPECT_EQ(3u, report.value.inlineNames);
+    EXPECT_EQ(1u, report.value.internedNames);
+    EXPECT_GE(report.value.files.contentBytes, 5u);
+    EXPECT_GT(report.value.files.nodeBytes, 2 * sizeof(File));
+    EXPECT_GT(report.value.indexBytes(), 0u);
+    EXPECT_EQ(report.value.metadataBytes() / 2, report.value.metadataPerFile());
+
+    fileSystem.displayMemoryUsage("missing");
+    ASSERT_EQ(1u, sink->getLines().size());
+    EXPECT_EQ("Directory not found: missing", sink->getLines()[0]);
+    fileSystem.displayMemoryUsage("");
+    ASSERT_EQ(8u, sink->getLines().size());
+    EXPECT_EQ(0u, sink->getLines()[2].find("file"));
+}
+
+TEST(TestMemoryReport, countsContentIndexPostingsAndLockFreeSnapshots)
+{
+    FileSystem fileSystem;
+    ASSERT_TRUE(fileSystem.createDirectories("a/b").ok());
+    ASSERT_TRUE(fileSystem.createFileAt("a/notes.txt").ok());
+    ASSERT_TRUE(fileSystem.appendToFile("a/notes.txt", "the quick brown fox jumps over the lazy dog").ok());
+    MemoryReport plain = fileSystem.measureMemoryAt("").value;
+    EXPECT_EQ(0u, plain.contentIndexBytes);
+    EXPECT_EQ(0u, plain.snapshotBytes);
+
+    fileSystem.setContentIndexEnabled(true);
+    MemoryReport indexed = fileSystem.measureMemoryAt("").value;
+    EXPECT_GT(indexed.contentIndexBytes, 0u);
+    EXPECT_GT(indexed.metadataBytes(), plain.metadataBytes());
+
+    fileSystem.setLockFreeReads(true);
+    MemoryReport lockFree = fileSystem.measureMemoryAt("").value;
+    EXPECT_GT(lockFree.snapshotBytes, 0u);
+    EXPECT_GT(lockFree.metadataBytes(), indexed.metadataBytes());
+    EXPECT_EQ(0u, fileSystem.measureMemoryAt("a/b").value.contentIndexBytes);
+}
+
+TEST(TestRecursiveRemove, rmdirDetachesSubtreeAndReclaimsItInTheBackground)
+{
+    FileSystem fileSystem;
+    ASSERT_TRUE(fileSystem.createDirectories("scratch/a/b").ok());
+    ASSERT_TRUE(fileSystem.createDirectories("kept").ok());
+    for (int index = 0; index < 100; ++index)
+    {
+        ASSERT_TRUE(fileSystem.createFileAt("scratch/a/b/f" + std::to_string(index) + ".log").ok());
+    }
+    ASSERT_TRUE(fileSystem.createFileAt("kept/f1.log").ok());
+    ASSERT_TRUE(fileSystem.enterDirectory("scratch/a").ok());
+
+    EXPECT_EQ(FsStatus::DirectoryNotEmpty, fileSystem.deleteDirectory("/scratch").status);
+    std::shared_ptr<OutputSink> previousSink = fileSystem.replaceOutputSink(std::make_shared<VectorSink>());
+    fileSystem.removeDirectory("-r /scratch");
+    fileSystem.replaceOutputSink(previousSink);
+    EXPECT_EQ("~", fileSystem.getPathOfWorkingDirectory());
+    EXPECT_EQ((std::vector<std::string>{"kept"}), fileSystem.listDirectory().value);
+
+    fileSystem.waitForReclamation();
+    EXPECT_EQ(103u, fileSystem.getReclaimedNodeCount());
+    TreeContext *context = fileSystem.getRootDirectory()->getContext();
+    EXPECT_EQ(1u, context->nameIndex.getIndexedFileCount());
+    EXPECT_EQ(1u, context->timeIndex.getIndexedFileCount());
+    FindQuery query;
+    query.pattern = "f1.log";
+    EXPECT_EQ((std::vector<std::string>{"~/kept/f1.log"}), fileSystem.find(query).value);
+}
+
+TEST(TestRecursiveRemove, rmRemovesMatchingDirectoriesAndReplaysFromJournal)
+{
+    std::string directory = testing::TempDir() + "vfs_journal_recursive";
+    std::filesystem::remove_all(directory);
+    {
+        FileSystem fileSystem;
+        ASSERT_TRUE(fileSystem.openJournal(directory).ok());
+        ASSERT_TRUE(fileSystem.createDirectories("tmp1/x").ok());
+        ASSERT_TRUE(fileSystem.createDirectories("tmp2").ok());
+        ASSERT_TRUE(fileSystem.createDirectories("logs/old/deep").ok());
+        ASSERT_TRUE(fileSystem.createFileAt("tmp1/x/file").ok());
+        ASSERT_TRUE(fileSystem.createFileAt("tmp.txt").ok());
+        EXPECT_EQ(FsStatus::NotFound, fileSystem.deleteFiles("tmp2").status);
+        EXPECT_EQ(3u, fileSystem.deleteFiles("tmp*", true).value);
+        EXPECT_TRUE(fileSystem.deleteDirectory("logs/old", true).ok());
+        EXPECT_EQ((std::vector<std::string>{"logs"}), fileSystem.listDirectory().value);
+    }
+    FileSystem restored;
+    ASSERT_TRUE(restored.openJournal(directory).ok());
+    EXPECT_EQ((std::vector<std::string>{"logs"}), restored.listDirectory().value);
+    EXPECT_TRUE(restored.listDirectory("logs").value.empty());
+    std::filesystem::remove_all(directory);
+}
+
+TEST(TestRecursiveRemove, sessionKeepsDetachedWorkingDirectoryAlive)
+{
+    FileSystem fileSystem;
+    Session first(fileSystem);
+    Session second(fileSystem);
+    ASSERT_TRUE(first.createDirectory("a/b").ok());
+    ASSERT_TRUE(first.createFile("a/b/note").ok());
+    ASSERT_TRUE(first.changeDirectory("a/b").ok());
+    EXPECT_TRUE(second.removeDirectory("a", true).ok());
+    EXPECT_EQ(FsStatus::PathNotFound, second.changeDirectory("a/b").status);
+    fileSystem.waitForReclamation();
+    EXPECT_EQ(FsStatus::NotFound, first.readFile("note").status);
+    EXPECT_TRUE(first.createFile("again").ok());
+    EXPECT_EQ(0u, fileSystem.getRootDirectory()->getContext()->nameIndex.getIndexedFileCount());
 }
\ No newline at end of file
@@ -0,0 +1,177 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "workload.hpp"
+
+static bool parseDistribution(const std::string &text, Distribution &distribution)
+{
+    std::istringstream fields(text);
+    std::string kind;
+    char separator = ':';
+    std::getline(fields, kind, ':');
+    if (kind == "fixed")
+    {
+        distribution.kind = DistributionKind::Fixed;
+        fields >> distribution.low;
+        distribution.high = distribution.low;
+    }
+    else if (kind == "uniform" || kind == "exp")
+    {
+        distribution.kind = kind == "uniform" ? DistributionKind::Uniform : DistributionKind::Exponential;
+        fields >> distribution.low >> separator >> distribution.high;
+    }
+    else
+    {
+        return false;
+    }
+    return !fields.fail() && separator == ':';
+}
+
+static bool parseMix(const std::string &text, WorkloadMix &mix)
+{
+    std::istringstream entries(text);
+    std::string entry;
+    while (std::getline(entries, entry, ','))
+    {
+        std::size_t equals = entry.find('=');
+        if (equals == std::string::npos)
+        {
+            return false;
+        }
+        std::string_view command = std::string_view(entry).substr(0, equals);
+        unsigned weight = static_cast<unsigned>(std::strtoul(entry.c_str() + equals + 1, nullptr, 10));
+        unsigned *target = command == "cd" ? &mix.cd : command == "ls" ? &mix.ls : command == "cat" ? &mix.cat : command == "find" ? &mix.find : command == "echo" ? &mix.echo : command == "rm" ? &mix.rm : nullptr;
+        if (target == nullptr)
+        {
+            return false;
+        }
+        *target = weight;
+    }
+    return true;
+}
+
+static void printUsage()
+{
+    std::cerr << "usage: vfsLoad [--seed N] [--depth N] [--dirs DIST] [--files DIST] [--file-size DIST]\n"
+                 "               [--dir-pattern P] [--file-pattern P] [--max-nodes N]\n"
+                 "               [--commands N] [--rate PER_SECOND] [--mix cd=W,ls=W,cat=W,find=W,echo=W,rm=W] [--dump-script]\n"
+                 "  DIST is fixed:N, uniform:LOW:HIGH or exp:MEAN:CAP; patterns use {n} for the index\n"
+                 "  --rate 0 replays closed-loop, otherwise arrivals are Poisson at the given rate\n";
+}
+
+static double microseconds(std::chrono::nanoseconds duration)
+{
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+int main(int argc, char *argv[])
+{
+    TreeShape shape;
+    WorkloadMix mix;
+    std::size_t commandCount = 100000;
+    double arrivalRate = 0;
+    bool dumpScript = false;
+    for (int index = 1; index < argc; ++index)
+    {
+        std::string_view option = argv[index];
+        bool hasValue = index + 1 < argc;
+        std::string value = hasValue ? argv[index + 1] : "";
+        bool parsed = hasValue;
+        if (option == "--dump-script")
+        {
+            dumpScript = true;
+            continue;
+        }
+        else if (option == "--seed" && hasValue)
+        {
+            shape.seed = std::strtoull(value.c_str(), nullptr, 10);
+        }
+        else if (option == "--depth" && hasValue)
+        {
+            shape.depth = std::atoi(value.c_str());
+        }
+        else if (option == "--dirs" && hasValue)
+        {
+            parsed = parseDistribution(value, shape.directoriesPerDirectory);
+        }
+        else if (option == "--files" && hasValue)
+        {
+            parsed = parseDistribution(value, shape.filesPerDirectory);
+        }
+        else if (option == "--file-size" && hasValue)
+        {
+            parsed = parseDistribution(value, shape.fileSize);
+        }
+        else if (option == "--dir-pattern" && hasValue)
+        {
+            shape.directoryPattern = value;
+        }
+        else if (option == "--file-pattern" && hasValue)
+        {
+            shape.filePattern = value;
+        }
+        else if (option == "--max-nodes" && hasValue)
+        {
+            shape.maxNodes = std::strtoull(value.c_str(), nullptr, 10);
+        }
+        else if (option == "--commands" && hasValue)
+        {
+            commandCount = std::strtoull(value.c_str(), nullptr, 10);
+        }
+        else if (option == "--rate" && hasValue)
+        {
+            arrivalRate = std::strtod(value.c_str(), nullptr);
+        }
+        else if (option == "--mix" && hasValue)
+        {
+            parsed = parseMix(value, mix);
+        }
+        else
+        {
+            parsed = false;
+        }
+        if (!parsed)
+        {
+            printUsage();
+            return 1;
+        }
+        ++index;
+    }
+
+    std::shared_ptr<FileSystem> fileSystem = std::make_shared<FileSystem>();
+    fileSystem->setOutputSink(std::make_shared<DiscardSink>());
+    auto generationStarted = std::chrono::steady_clock::now();
+    GeneratedTree tree = generateTree(*fileSystem, shape);
+    auto generationTime = std::chrono::steady_clock::now() - generationStarted;
+    std::string workload = generateWorkload(tree, mix, commandCount, shape.seed);
+    if (dumpScript)
+    {
+        std::cout << workload;
+        return 0;
+    }
+    std::cerr << "generated " << tree.directories.size() << " directories, " << tree.files.size() << " files, "
+              << tree.contentBytes << " content bytes in " << std::fixed << std::setprecision(1)
+              << std::chrono::duration<double, std::milli>(generationTime).count() << " ms\n";
+
+    FsResult<CommandScript> script = CommandScript::parse(workload);
+    if (!script.ok())
+    {
+        std::cerr << "Cannot replay workload: " << script.detail << '\n';
+        return 1;
+    }
+    CommandExecutor commandExecutor(fileSystem);
+    ReplayReport report = replayWorkload(commandExecutor, script.value, arrivalRate, shape.seed);
+    std::cout << std::fixed << std::setprecision(2)
+              << "commands   " << report.commands << '\n'
+              << "throughput " << report.throughput() << " ops/s\n"
+              << "p50        " << microseconds(report.p50) << " us\n"
+              << "p99        " << microseconds(report.p99) << " us\n"
+              << "p999       " << microseconds(report.p999) << " us\n"
+              << "max        " << microseconds(report.maximum) << " us\n";
+}
\ No newline at end of file
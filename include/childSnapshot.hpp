@@ -0,0 +1,37 @@
+#ifndef CHILDSNAPSHOT_HPP
+#define CHILDSNAPSHOT_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "childTable.hpp"
+
+class ChildSnapshot
+{
+public:
+    using Entry = ChildTable::Entry;
+    static constexpr std::size_t blockCapacity = ChildTable::blockCapacity;
+
+private:
+    using Block = std::vector<Entry>;
+
+    std::vector<std::shared_ptr<const Block>> blocks;
+    std::size_t entryCount = 0;
+
+    std::size_t blockFor(std::string_view name) const;
+
+public:
+    ChildSnapshot() = default;
+    explicit ChildSnapshot(const ChildTable &table);
+
+    std::size_t size() const { return entryCount; }
+    std::size_t allocatedBytes() const;
+    const Entry *find(std::string_view name) const;
+    std::unique_ptr<ChildSnapshot> withChild(std::string_view name, const std::shared_ptr<FileSystemComponent> &child) const;
+    std::unique_ptr<ChildSnapshot> withoutChild(std::string_view name) const;
+};
+
+#endif
\ No newline at end of file
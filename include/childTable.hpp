@@ -0,0 +1,91 @@
+#ifndef CHILDTABLE_HPP
+#define CHILDTABLE_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "nodeName.hpp"
+
+class FileSystemComponent;
+
+class ChildTable
+{
+public:
+    using Entry = std::pair<NodeName, std::shared_ptr<FileSystemComponent>>;
+    static constexpr std::size_t blockCapacity = 256;
+
+    class const_iterator
+    {
+    private:
+        const ChildTable *table = nullptr;
+        std::size_t block = 0;
+        std::size_t position = 0;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Entry;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Entry *;
+        using reference = const Entry &;
+
+        const_iterator() = default;
+        const_iterator(const ChildTable *owner, std::size_t blockIndex, std::size_t entryIndex)
+            : table(owner), block(blockIndex), position(entryIndex) {}
+
+        reference operator*() const { return table->blocks[block][position]; }
+        pointer operator->() const { return &table->blocks[block][position]; }
+        const_iterator &operator++()
+        {
+            if (++position == table->blocks[block].size())
+            {
+                ++block;
+                position = 0;
+            }
+            return *this;
+        }
+        const_iterator operator++(int)
+        {
+            const_iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+        bool operator==(const const_iterator &other) const { return block == other.block && position == other.position; }
+    };
+
+private:
+    using Block = std::pmr::vector<Entry>;
+
+    std::pmr::vector<Block> blocks;
+    std::size_t entryCount = 0;
+
+    std::size_t blockFor(std::string_view name) const;
+    const_iterator lowerBoundIn(std::size_t block, std::string_view name) const;
+
+public:
+    explicit ChildTable(std::pmr::memory_resource *resource = std::pmr::get_default_resource()) : blocks(resource) {}
+
+    std::size_t size() const { return entryCount; }
+    bool empty() const { return entryCount == 0; }
+    std::size_t blockCount() const { return blocks.size(); }
+    std::size_t allocatedBytes() const;
+    const_iterator begin() const { return const_iterator(this, 0, 0); }
+    const_iterator end() const { return const_iterator(this, blocks.size(), 0); }
+
+    const Entry *find(std::string_view name) const;
+    std::shared_ptr<FileSystemComponent> &findOrInsert(const NodeName &name);
+    bool erase(std::string_view name);
+    void clear();
+
+    const_iterator lowerBound(std::string_view name) const;
+    const_iterator upperBound(std::string_view name) const;
+    const_iterator atOffset(std::size_t offset) const;
+    std::pair<const_iterator, const_iterator> prefixRange(std::string_view prefix) const;
+};
+
+#endif
\ No newline at end of file
@@ -2,14 +2,19 @@
 #define COMMANDEXECUTOR_HPP
 
 #include <algorithm>
+#include <functional>
+#include <istream>
+#include <ostream>
 
+#include "commandScript.hpp"
 #include "fileSystem.hpp"
 
 class CommandExecutor
 {
 public:
     using CommandFunction = std::function<void(void)>;
-    CommandExecutor()
+    CommandExecutor() : CommandExecutor(std::make_shared<FileSystem>()) {}
+    CommandExecutor(std::shared_ptr<FileSystem> fileSystem) : fileSystemObject(std::move(fileSystem))
     {
         commandMap["cd"] = std::bind(&CommandExecutor::handlecd, this);
         commandMap["mkdir"] = std::bind(&CommandExecutor::handlemkdir, this);
@@ -20,21 +25,12 @@ public:
         commandMap["rmdir"] = std::bind(&CommandExecutor::handlermdir, this);
         commandMap["rm"] = std::bind(&CommandExecutor::handlermfile, this);
         commandMap["find"] = std::bind(&CommandExecutor::handlefindFile, this);
+        commandMap["save"] = std::bind(&CommandExecutor::handlesave, this);
+        commandMap["load"] = std::bind(&CommandExecutor::handleload, this);
+        commandMap["stats"] = std::bind(&CommandExecutor::handlestats, this);
+        commandMap["du"] = std::bind(&CommandExecutor::handledu, this);
     }
-    CommandExecutor(std::shared_ptr<FileSystem> fileSystem)
-    {
-        fileSystemObject = fileSystem;
-        commandMap["cd"] = std::bind(&CommandExecutor::handlecd, this);
-        commandMap["mkdir"] = std::bind(&CommandExecutor::handlemkdir, this);
-        commandMap["cat"] = std::bind(&CommandExecutor::handlecat, this);
-        commandMap["touch"] = std::bind(&CommandExecutor::handletouch, this);
-        commandMap["echo"] = std::bind(&CommandExecutor::handleecho, this);
-        commandMap["ls"] = std::bind(&CommandExecutor::handlels, this);
-        commandMap["rmdir"] = std::bind(&CommandExecutor::handlermdir, this);
-        commandMap["rm"] = std::bind(&CommandExecutor::handlermfile, this);
-        commandMap["find"] = std::bind(&CommandExecutor::handlefindFile, this);
-    }
-    ~CommandExecutor() {}
+    virtual ~CommandExecutor() {}
 
     virtual bool isCommandName(const std::string &commandName);
     virtual void separateCommandLine(const std::string &readCommandLine);
@@ -48,9 +44,16 @@ public:
     virtual void handlermdir();
     virtual void handlermfile();
     virtual void handlefindFile();
+    virtual void handlesave();
+    virtual void handleload();
+    virtual void handlestats();
+    virtual void handledu();
+    void executeInstruction(const CommandScript &script, const ScriptInstruction &instruction);
+    std::vector<CommandLatency> executeScript(const CommandScript &script);
+    void runBatch(std::istream &input, std::ostream &summary = std::cerr);
 
 private:
-    std::shared_ptr<FileSystem> fileSystemObject = std::make_shared<FileSystem>();
+    std::shared_ptr<FileSystem> fileSystemObject;
     std::vector<std::string> listOfCommands;
     std::string command;
     std::string arguments;
@@ -0,0 +1,73 @@
+#ifndef COMMANDSCRIPT_HPP
+#define COMMANDSCRIPT_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "fsResult.hpp"
+
+enum class Opcode : std::uint8_t
+{
+    ChangeDirectory,
+    MakeDirectory,
+    Cat,
+    Touch,
+    Echo,
+    List,
+    RemoveDirectory,
+    Remove,
+    Find,
+    Save,
+    Load,
+    Stats,
+    DiskUsage,
+    Help,
+    Unknown
+};
+
+struct ScriptInstruction
+{
+    Opcode opcode;
+    std::uint32_t argumentOffset;
+    std::uint32_t argumentLength;
+    std::uint32_t textOffset;
+    std::uint32_t textLength;
+};
+
+struct CommandLatency
+{
+    std::string command;
+    std::size_t count = 0;
+    std::chrono::nanoseconds total{0};
+    std::chrono::nanoseconds median{0};
+    std::chrono::nanoseconds p99{0};
+    std::chrono::nanoseconds maximum{0};
+};
+
+class CommandScript
+{
+private:
+    std::vector<ScriptInstruction> instructions;
+    std::string pool;
+
+    std::uint32_t store(std::string_view text);
+
+public:
+    static constexpr std::size_t opcodeCount = static_cast<std::size_t>(Opcode::Unknown) + 1;
+    static constexpr std::size_t poolLimit = std::numeric_limits<std::uint32_t>::max();
+
+    static FsResult<CommandScript> parse(std::string_view script);
+    static Opcode opcodeFor(std::string_view command);
+    static const char *commandName(Opcode opcode);
+
+    const std::vector<ScriptInstruction> &getInstructions() const { return instructions; }
+    std::string_view argument(const ScriptInstruction &instruction) const { return std::string_view(pool).substr(instruction.argumentOffset, instruction.argumentLength); }
+    std::string_view text(const ScriptInstruction &instruction) const { return std::string_view(pool).substr(instruction.textOffset, instruction.textLength); }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,41 @@
+#ifndef CONTENTINDEX_HPP
+#define CONTENTINDEX_HPP
+
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class File;
+class FileSystemComponent;
+
+class ContentIndex
+{
+private:
+    std::unordered_map<std::uint32_t, std::unordered_set<File *>> postings;
+
+    static void collectTrigrams(std::string_view text, std::vector<std::uint32_t> &trigrams);
+    static void collectFileTrigrams(const File &file, std::vector<std::uint32_t> &trigrams);
+
+public:
+    static constexpr std::size_t gramLength = 3;
+
+    void addContent(File *file, std::string_view previousTail, std::string_view appendedText);
+    void addSubtree(FileSystemComponent *component);
+    void removeSubtree(FileSystemComponent *component);
+    bool canNarrow(std::string_view needle) const { return needle.size() >= gramLength; }
+    std::vector<File *> findCandidates(std::string_view needle) const;
+    std::size_t getTrigramCount() const { return postings.size(); }
+    template <typename Visitor>
+    void forEachPostingList(Visitor &&visitor) const
+    {
+        for (auto &posting : postings)
+        {
+            visitor(posting.second);
+        }
+    }
+    void clear() { postings.clear(); }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,38 @@
+#ifndef CONTENTSEARCH_HPP
+#define CONTENTSEARCH_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "fileContent.hpp"
+
+enum class SearchKernel
+{
+    Scalar,
+    Sse2,
+    Avx2
+};
+
+SearchKernel bestSearchKernel();
+const char *searchKernelName(SearchKernel kernel);
+std::size_t findSubstring(std::string_view text, std::string_view needle, bool ignoreCase = false);
+std::size_t findSubstring(std::string_view text, std::string_view needle, bool ignoreCase, SearchKernel kernel);
+
+class ContentMatcher
+{
+private:
+    std::vector<std::string> patterns;
+    bool ignoreCase;
+
+public:
+    ContentMatcher(std::vector<std::string> patternsToFind, bool caseInsensitive = false);
+    ContentMatcher(const std::string &pattern, bool caseInsensitive = false) : ContentMatcher(std::vector<std::string>{pattern}, caseInsensitive) {}
+
+    const std::vector<std::string> &getPatterns() const { return patterns; }
+    bool isCaseInsensitive() const { return ignoreCase; }
+    bool matches(std::string_view text) const;
+    bool matches(const FileContent &content) const;
+};
+
+#endif
\ No newline at end of file
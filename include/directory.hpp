@@ -1,26 +1,87 @@
 #ifndef DIRECTORY_HPP
 #define DIRECTORY_HPP
 
+#include <atomic>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <limits>
 #include <memory>
+#include <memory_resource>
+#include <string_view>
+#include <functional>
+#include <shared_mutex>
+#include "childSnapshot.hpp"
+#include "childTable.hpp"
 #include "fileSystemComponent.hpp"
+#include "treeContext.hpp"
+#include "globPattern.hpp"
+#include "outputSink.hpp"
 
-class Directory : public FileSystemComponent
+struct ChildNameHash
+{
+    using is_transparent = void;
+    std::size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+};
+
+struct ListingCursor
+{
+    std::size_t offset = 0;
+    std::size_t limit = std::numeric_limits<std::size_t>::max();
+    std::string after;
+};
+
+class Directory : public FileSystemComponent, public std::enable_shared_from_this<Directory>
 {
 private:
-    std::string directoryName;
-    std::unordered_map<std::string, std::shared_ptr<FileSystemComponent>> children;
+    ChildTable children;
+    std::shared_ptr<TreeContext> treeContext;
+    mutable std::shared_mutex childrenMutex;
+    std::atomic<const ChildSnapshot *> publishedChildren{nullptr};
+    std::unordered_map<std::string, std::unordered_set<FileSystemComponent *>, ChildNameHash, std::equal_to<>> childrenByExtension;
+
+    void detachChild(const std::shared_ptr<FileSystemComponent> &child);
+    void forgetExtension(FileSystemComponent *child);
+    static std::string_view extensionOf(std::string_view name);
+    void publishChildren(std::unique_ptr<ChildSnapshot> snapshot);
 
 public:
-    Directory(std::string name) : directoryName(name) {}
+    Directory(std::string_view directoryName, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        : FileSystemComponent(NodeKind::Directory, directoryName), children(resource) {}
+    ~Directory();
 
-    std::string getName() override { return directoryName; }
-    std::string getComponentType() override { return "Directory"; }
+    std::string getName() override { return name.str(); }
     virtual void addChild(const std::shared_ptr<FileSystemComponent> &child);
-    std::unordered_map<std::string, std::shared_ptr<FileSystemComponent>> getSubDirectories() { return children; }
+    ChildTable getSubDirectories() { return children; }
+    const ChildTable &getChildren() const { return children; }
+    FileSystemComponent *findChild(std::string_view name) const;
+    std::shared_ptr<FileSystemComponent> getChild(std::string_view name) const;
     virtual void removeChild(const std::string &directoryName);
+    std::shared_ptr<FileSystemComponent> detachSubtree(std::string_view name);
+    void takeChildren(std::vector<std::shared_ptr<FileSystemComponent>> &taken);
     void displayChildren();
-    std::time_t getTimestamp() override { return creationTime; }
+    void displayChildren(OutputSink &sink, const ListingCursor &cursor = {}, const GlobPattern *pattern = nullptr);
+    void forEachListedChild(const ListingCursor &cursor, const GlobPattern *pattern, const std::function<void(const ChildTable::Entry &)> &visitor) const;
+    std::vector<FileSystemComponent *> findMatchingChildren(const GlobPattern &pattern) const;
+    TreeContext *getContext() const { return treeContext.get(); }
+    const std::shared_ptr<TreeContext> &getSharedContext() const { return treeContext; }
+    std::shared_mutex &getMutex() const { return childrenMutex; }
+    void setContext(const std::shared_ptr<TreeContext> &context);
+    void setLockFreeReads(bool enabled);
+    std::size_t getExtensionCount() const { return childrenByExtension.size(); }
+    bool hasLockFreeReads() const { return publishedChildren.load(std::memory_order_acquire) != nullptr; }
+    std::size_t getSnapshotBytes() const;
+    std::time_t getTimestamp() const override { return std::chrono::system_clock::to_time_t(std::chrono::time_point_cast<std::chrono::system_clock::duration>(creationTime)); }
 };
 
+inline Directory *asDirectory(FileSystemComponent *component)
+{
+    return component != nullptr && component->isDirectory() ? static_cast<Directory *>(component) : nullptr;
+}
+
+inline const Directory *asDirectory(const FileSystemComponent *component)
+{
+    return component != nullptr && component->isDirectory() ? static_cast<const Directory *>(component) : nullptr;
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,72 @@
+#ifndef EPOCHDOMAIN_HPP
+#define EPOCHDOMAIN_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+class EpochDomain
+{
+private:
+    struct alignas(64) ReaderRecord
+    {
+        std::atomic<std::uint64_t> pinnedEpoch{0};
+        std::atomic<bool> inUse{false};
+        ReaderRecord *next = nullptr;
+    };
+
+    struct RetiredObject
+    {
+        std::uint64_t epoch;
+        void *object;
+        void (*deleter)(void *);
+    };
+
+    static constexpr std::size_t reclaimThreshold = 64;
+
+    std::atomic<std::uint64_t> globalEpoch{1};
+    std::atomic<ReaderRecord *> readers{nullptr};
+    std::mutex retiredMutex;
+    std::vector<RetiredObject> retired;
+    std::atomic<std::size_t> retiredCount{0};
+
+    EpochDomain() = default;
+    ReaderRecord *acquireRecord();
+    void releaseRecord(ReaderRecord *record);
+    std::uint64_t oldestPinnedEpoch() const;
+    void retireObject(void *object, void (*deleter)(void *));
+    std::size_t reclaim(std::unique_lock<std::mutex> &retiredLock);
+    void reclaimOnExit();
+
+    friend class EpochGuard;
+    friend struct ThreadReaderState;
+
+public:
+    EpochDomain(const EpochDomain &) = delete;
+    EpochDomain &operator=(const EpochDomain &) = delete;
+    ~EpochDomain();
+
+    static EpochDomain &instance();
+
+    template <typename T>
+    void retire(const T *object)
+    {
+        retireObject(const_cast<T *>(object), [](void *retiredObject)
+                     { delete static_cast<T *>(retiredObject); });
+    }
+    std::size_t reclaim();
+    void synchronize();
+    std::size_t pendingCount();
+};
+
+class EpochGuard
+{
+public:
+    EpochGuard();
+    ~EpochGuard();
+    EpochGuard(const EpochGuard &) = delete;
+    EpochGuard &operator=(const EpochGuard &) = delete;
+};
+
+#endif
\ No newline at end of file
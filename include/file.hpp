@@ -2,21 +2,33 @@
 #define FILE_HPP
 
 #include "fileSystemComponent.hpp"
+#include "fileContent.hpp"
 
 class File : public FileSystemComponent
 {
 private:
-    std::string content{};
-    std::string fileName{};
+    FileContent content;
 
 public:
-    File(std::string name) : fileName(name) {}
+    File(std::string_view fileName) : FileSystemComponent(NodeKind::File, fileName) {}
     virtual void setContent(const std::string &);
     std::string getContent() const;
+    const FileContent &getFileContent() const { return content; }
+    void mapContent(std::string_view extent, std::shared_ptr<const void> mapping) { content.assignMapped(extent, std::move(mapping)); }
+    std::size_t getSize() const { return content.size(); }
 
-    std::string getName() override { return fileName; }
-    std::string getComponentType() override { return "File"; }
-    std::time_t getTimestamp() override { return creationTime; }
+    std::string getName() override { return name.str(); }
+    std::time_t getTimestamp() const override { return std::chrono::system_clock::to_time_t(std::chrono::time_point_cast<std::chrono::system_clock::duration>(creationTime)); }
 };
 
+inline File *asFile(FileSystemComponent *component)
+{
+    return component != nullptr && component->isFile() ? static_cast<File *>(component) : nullptr;
+}
+
+inline const File *asFile(const FileSystemComponent *component)
+{
+    return component != nullptr && component->isFile() ? static_cast<const File *>(component) : nullptr;
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,57 @@
+#ifndef FILECONTENT_HPP
+#define FILECONTENT_HPP
+
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class FileContent
+{
+private:
+    static constexpr std::size_t smallestChunk = 256;
+    static constexpr std::size_t largestChunk = 1024 * 1024;
+
+    struct Chunk
+    {
+        std::unique_ptr<char[]> storage;
+        const char *data = nullptr;
+        std::size_t size = 0;
+        std::size_t capacity = 0;
+        std::string_view view() const { return std::string_view(data, size); }
+    };
+
+    std::vector<Chunk> chunks;
+    std::size_t totalSize = 0;
+    std::shared_ptr<const void> mappingOwner;
+
+public:
+    static constexpr std::size_t npos = std::string::npos;
+
+    void append(std::string_view text);
+    void assignMapped(std::string_view extent, std::shared_ptr<const void> owner);
+    void clear();
+    bool isMapped() const { return mappingOwner != nullptr; }
+    std::size_t size() const { return totalSize; }
+    bool empty() const { return totalSize == 0; }
+    std::size_t chunkCount() const { return chunks.size(); }
+    std::size_t chunkTableBytes() const { return chunks.capacity() * sizeof(Chunk); }
+    std::size_t allocatedBytes() const;
+    std::string_view chunk(std::size_t index) const { return chunks[index].view(); }
+    std::size_t read(std::size_t offset, std::span<char> destination) const;
+    std::string read(std::size_t offset, std::size_t length) const;
+    std::size_t find(std::string_view needle, bool ignoreCase = false) const;
+    std::string toString() const;
+
+    template <typename Visitor>
+    void forEachChunk(Visitor &&visitor) const
+    {
+        for (auto &eachChunk : chunks)
+        {
+            visitor(eachChunk.view());
+        }
+    }
+};
+
+#endif
\ No newline at end of file
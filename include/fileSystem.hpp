@@ -2,28 +2,86 @@
 #define FILESYSTEM_HPP
 
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <vector>
+#include <utility>
 #include <chrono>
 
 #include "directory.hpp"
+#include "epochDomain.hpp"
 #include "file.hpp"
+#include "pathResolver.hpp"
+#include "nodeArena.hpp"
+#include "workStealingPool.hpp"
+#include "contentSearch.hpp"
+#include "outputSink.hpp"
+#include "fsResult.hpp"
+#include "instrumentation.hpp"
+#include "journal.hpp"
+#include "memoryReport.hpp"
+#include "subtreeReclaimer.hpp"
 
 class FileSystem
 {
 private:
+    std::unique_ptr<NodeArena, NodeArena::Releaser> nodeArena{new NodeArena};
     std::shared_ptr<Directory> rootDirectory;
-    std::string pathOfWorkingDirectory;
     std::shared_ptr<Directory> workingDirectory;
+    PathResolver pathResolver;
+    std::unique_ptr<WorkStealingPool> findPool;
+    std::shared_ptr<OutputSink> outputSink = std::make_shared<BufferedStreamSink>();
+    bool ignoreContentCase = false;
+    std::unique_ptr<Journal> journal;
+    std::string journalDirectory;
+    std::uint64_t journalGeneration = 0;
+    JournalOptions journalOptions;
+    SubtreeReclaimer subtreeReclaimer;
+
+    using FileMatcher = std::function<bool(std::string_view, const FileSystemComponent &)>;
+
+    FsResult<Directory *> resolveParentDirectory(const std::string &, std::string_view &);
+    FsResult<File *> findFileAt(const std::string &);
+    void collectByName(const std::string &, const Directory &, const std::string &, std::vector<std::string> &);
+    void collectByTime(Timestamp, const Directory &, const std::string &, std::vector<std::string> &);
+    void collectByContent(const ContentMatcher &, const Directory &, const std::string &, std::vector<std::string> &);
+    void walkByName(const std::string &, const Directory &, std::string &, std::vector<std::string> &);
+    void walkByTime(Timestamp, const Directory &, std::string &, std::vector<std::string> &);
+    void walkByContent(const ContentMatcher &, const Directory &, std::string &, std::vector<std::string> &);
+    static void appendPath(std::string &, std::string_view);
+    bool findWithContentIndex(const ContentMatcher &, const Directory &, const std::string &, std::vector<std::string> &);
+    bool findWithNameIndex(const std::string &, const Directory &, const std::string &, std::vector<std::string> &);
+    bool findWithTimeIndex(Timestamp, const Directory &, const std::string &, std::vector<std::string> &);
+    void collectByGlob(const GlobPattern &, const Directory &, const std::string &, std::vector<std::string> &);
+    static void walkByGlob(const GlobPattern &, const Directory &, std::string &, std::size_t, std::vector<std::string> &);
+    static bool contentMatches(const ContentMatcher &, const File &);
+    static bool modifiedSince(Timestamp, const FileSystemComponent &);
+    static bool pathUnderDirectory(FileSystemComponent *, const Directory &, const std::string &, std::string &);
+    void printSortedPaths(std::vector<std::string> &);
+    bool journalOperation(JournalOperation, const std::string &, Timestamp, const std::string & = {});
+    void applyJournalRecord(const JournalRecord &);
+    void restoreFileTimes(File *, Timestamp, Timestamp);
+    void detachAndReclaim(Directory &, std::string_view);
+    bool findInParallel(const Directory &, const std::string &, const FileMatcher &, std::vector<std::string> &);
+    void scanInParallel(const Directory &, std::string, const FileMatcher &, std::vector<std::vector<std::string>> &, std::atomic<std::size_t> &);
 
 public:
     FileSystem()
     {
-        rootDirectory = std::make_shared<Directory>("root");
+        rootDirectory = makeDirectory("root");
+        rootDirectory->setContext(std::make_shared<TreeContext>());
         workingDirectory = rootDirectory;
-        pathOfWorkingDirectory = "~";
     }
-    virtual ~FileSystem() = default;
+    virtual ~FileSystem()
+    {
+        subtreeReclaimer.drain();
+        if (rootDirectory->hasLockFreeReads())
+        {
+            rootDirectory->setLockFreeReads(false);
+        }
+        // Retired snapshots still own nodes, so free them now and let the arena go with the tree.
+        EpochDomain::instance().synchronize();
+    }
 
     virtual void createDirectory(const std::string &);
     virtual void changeDirectory(const std::string &path = " ");
@@ -32,15 +90,63 @@ public:
     virtual void createFile(const std::string &);
     virtual void writeToFile(const std::string &);
     virtual void displayFileContent(const std::string &);
-    virtual std::string getPathOfWorkingDirectory() const { return pathOfWorkingDirectory; }
+    virtual std::string getPathOfWorkingDirectory() const { return getPathOf(workingDirectory.get()); }
+    std::string getPathOf(FileSystemComponent *) const;
     virtual void displayFiles();
+    virtual void listFiles(const std::string &);
     virtual void removeDirectory(const std::string &);
     virtual void removeFile(const std::string &);
     virtual void findFile(const std::string &);
     virtual void fileFound(const std::string &, const std::pair<std::string, std::shared_ptr<FileSystemComponent>> &, std::string);
     virtual void findByTime(const int &, const std::pair<std::string, std::shared_ptr<FileSystemComponent>> &, std::string);
     virtual void findByContent(const std::string &, const std::pair<std::string, std::shared_ptr<FileSystemComponent>> &, std::string);
+    virtual void saveSnapshot(const std::string &path);
+    virtual void loadSnapshot(const std::string &path);
+    virtual void displayStats(const std::string &arguments);
+    virtual void displayMemoryUsage(const std::string &path);
+
+    FsResult<Directory *> createDirectories(const std::string &path);
+    FsResult<Directory *> resolveDirectory(const std::string &path);
+    FsResult<Directory *> enterDirectory(const std::string &path);
+    FsResult<File *> createFileAt(const std::string &path);
+    FsResult<File *> appendToFile(const std::string &path, const std::string &text);
+    FsResult<const FileContent *> readFile(const std::string &path);
+    FsResult<std::vector<std::string>> listDirectory(const std::string &path = "", const ListingCursor &cursor = {}, const std::string &pattern = "");
+    FsResult<> deleteDirectory(const std::string &path, bool recursive = false);
+    FsResult<std::size_t> deleteFiles(const std::string &pattern, bool recursive = false);
+    FsResult<std::vector<std::string>> find(const FindQuery &query);
+    FsResult<std::vector<std::string>> findUnder(const FindQuery &query, const Directory &startDirectory, const std::string &startPath);
+    FsResult<std::size_t> saveSnapshotTo(const std::string &path);
+    FsResult<> loadSnapshotFrom(const std::string &path);
+    FsResult<std::size_t> openJournal(const std::string &directory, const JournalOptions &options = {});
+    FsResult<> compactJournal();
+    FsResult<MemoryReport> measureMemoryAt(const std::string &path = "");
+    bool syncJournal() { return journal == nullptr || journal->sync(); }
+
+    std::shared_ptr<Directory> makeDirectory(const std::string &name)
+    {
+        return std::allocate_shared<Directory>(ArenaAllocator<Directory>(nodeArena.get()), name, nodeArena.get());
+    }
+    std::shared_ptr<File> makeFile(const std::string &name)
+    {
+        return std::allocate_shared<File>(ArenaAllocator<File>(nodeArena.get()), name);
+    }
+    NodeArena &getNodeArena() { return *nodeArena; }
+    void reclaimSubtree(std::shared_ptr<FileSystemComponent> subtree, std::shared_ptr<TreeContext> context) { subtreeReclaimer.submit(std::move(subtree), std::move(context)); }
+    void waitForReclamation() { subtreeReclaimer.drain(); }
+    std::size_t getReclaimedNodeCount() { return subtreeReclaimer.getReclaimedNodeCount(); }
+    void setFindThreadCount(std::size_t threadCount);
+    void setContentIndexEnabled(bool enabled);
+    void setLockFreeReads(bool enabled) { rootDirectory->setLockFreeReads(enabled); }
+    bool hasLockFreeReads() const { return rootDirectory->hasLockFreeReads(); }
+    bool isContentIndexEnabled() const { return rootDirectory->getContext()->contentIndex != nullptr; }
+    std::size_t getFindThreadCount() const { return findPool == nullptr ? 1 : findPool->getThreadCount(); }
+    OutputSink &getOutputSink() { return *outputSink; }
+    void setOutputSink(const std::shared_ptr<OutputSink> &sink) { outputSink = sink; }
+    std::shared_ptr<OutputSink> replaceOutputSink(std::shared_ptr<OutputSink> sink) { return std::exchange(outputSink, std::move(sink)); }
 
+    std::shared_ptr<Directory> getRootDirectory() const { return rootDirectory; }
+    std::shared_ptr<Directory> getWorkingDirectory() const { return workingDirectory; }
     void setWorkingDirectory(const std::shared_ptr<Directory> &directory)
     {
         workingDirectory = directory;
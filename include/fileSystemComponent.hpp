@@ -4,17 +4,62 @@
 #include <iostream>
 #include <memory>
 #include <ctime>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "nodeName.hpp"
+
+class Directory;
+
+using Timestamp = std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds>;
+
+inline Timestamp currentTimestamp()
+{
+    return std::chrono::time_point_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now());
+}
+
+// "." and ".." are path navigation, and '/' separates segments, so none of them can name a node.
+inline bool isValidNodeName(std::string_view name)
+{
+    return !name.empty() && name != "." && name != ".." && name.find('/') == std::string_view::npos;
+}
+
+enum class NodeKind : std::uint8_t
+{
+    File,
+    Directory
+};
 
 class FileSystemComponent
 {
 protected:
-    std::time_t creationTime = std::time(nullptr);
+    Timestamp creationTime = currentTimestamp();
+    Timestamp modificationTime = creationTime;
+    Directory *parentDirectory = nullptr;
+    NodeName name;
+    NodeKind kind;
 
 public:
-    FileSystemComponent() { std::ctime(&creationTime); }
+    FileSystemComponent(NodeKind nodeKind, std::string_view componentName) : name(componentName), kind(nodeKind) {}
+    Directory *getParent() const { return parentDirectory; }
+    void setParent(Directory *parent) { parentDirectory = parent; }
+    NodeKind getKind() const { return kind; }
+    bool isFile() const { return kind == NodeKind::File; }
+    bool isDirectory() const { return kind == NodeKind::Directory; }
     virtual std::string getName() = 0;
-    virtual std::string getComponentType() = 0;
-    virtual std::time_t getTimestamp() = 0;
+    std::string_view getNameView() const { return name.view(); }
+    const NodeName &getNodeName() const { return name; }
+    std::string getComponentType() const { return isFile() ? "File" : "Directory"; }
+    virtual std::time_t getTimestamp() const = 0;
+    Timestamp getCreationTime() const { return creationTime; }
+    Timestamp getModificationTime() const { return modificationTime; }
+    void restoreTimes(Timestamp created, Timestamp modified)
+    {
+        creationTime = created;
+        modificationTime = modified;
+    }
     virtual ~FileSystemComponent() {}
 };
 
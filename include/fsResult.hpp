@@ -0,0 +1,77 @@
+#ifndef FSRESULT_HPP
+#define FSRESULT_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <variant>
+
+enum class FsStatus : std::uint8_t
+{
+    Ok,
+    NotFound,
+    PathNotFound,
+    NotADirectory,
+    NotAFile,
+    DirectoryNotEmpty,
+    InvalidArgument,
+    IoError,
+    CorruptData
+};
+
+inline const char *describeStatus(FsStatus status)
+{
+    switch (status)
+    {
+    case FsStatus::Ok:
+        return "ok";
+    case FsStatus::NotFound:
+        return "not found";
+    case FsStatus::PathNotFound:
+        return "path not found";
+    case FsStatus::NotADirectory:
+        return "not a directory";
+    case FsStatus::NotAFile:
+        return "not a file";
+    case FsStatus::DirectoryNotEmpty:
+        return "directory not empty";
+    case FsStatus::InvalidArgument:
+        return "invalid argument";
+    case FsStatus::IoError:
+        return "i/o error";
+    case FsStatus::CorruptData:
+        return "corrupt data";
+    }
+    return "unknown";
+}
+
+template <typename T = std::monostate>
+struct FsResult
+{
+    FsStatus status = FsStatus::Ok;
+    T value{};
+    std::string detail;
+
+    bool ok() const { return status == FsStatus::Ok; }
+
+    static FsResult success(T resultValue) { return FsResult{FsStatus::Ok, std::move(resultValue), {}}; }
+    static FsResult failure(FsStatus failureStatus, std::string failureDetail = {}) { return FsResult{failureStatus, T{}, std::move(failureDetail)}; }
+};
+
+enum class FindKind : std::uint8_t
+{
+    Name,
+    ModifiedWithin,
+    Content
+};
+
+struct FindQuery
+{
+    FindKind kind = FindKind::Name;
+    std::string pattern;
+    std::chrono::seconds range{0};
+    std::string startPath;
+    bool ignoreCase = false;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,57 @@
+#ifndef GLOBPATTERN_HPP
+#define GLOBPATTERN_HPP
+
+#include <bitset>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class GlobPattern
+{
+private:
+    enum class TokenKind : std::uint8_t
+    {
+        Character,
+        AnyCharacter,
+        CharacterClass,
+        Star,
+        DoubleStar,
+        DirectoryPrefix
+    };
+
+    struct Token
+    {
+        TokenKind kind;
+        char character = 0;
+        std::uint32_t characterClass = 0;
+    };
+
+    std::string pattern;
+    std::string unescaped;
+    std::vector<Token> tokens;
+    std::vector<std::bitset<256>> characterClasses;
+    std::string literalPrefix;
+    std::string literalSuffix;
+    bool literal = true;
+    bool suffixOnly = false;
+
+    std::size_t parseCharacterClass(std::size_t position);
+    void addClosure(std::uint64_t *states, bool atSegmentStart) const;
+
+public:
+    explicit GlobPattern(std::string_view text);
+
+    static bool hasWildcards(std::string_view text);
+    bool matches(std::string_view text) const;
+    const std::string &getPattern() const { return pattern; }
+    bool isLiteral() const { return literal; }
+    // The name a literal pattern stands for, with escapes removed.
+    const std::string &getLiteralText() const { return unescaped; }
+    bool isSuffixPattern() const { return suffixOnly; }
+    std::string_view getLiteralPrefix() const { return literalPrefix; }
+    std::string_view getLiteralSuffix() const { return literalSuffix; }
+    bool matchesAcrossSegments() const { return pattern.find('/') != std::string::npos; }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,174 @@
+#ifndef INSTRUMENTATION_HPP
+#define INSTRUMENTATION_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define VFS_TSC_CLOCK
+#endif
+
+enum class StatOperation : std::uint8_t
+{
+    CreateDirectory,
+    ChangeDirectory,
+    CreateFile,
+    Append,
+    Read,
+    List,
+    RemoveDirectory,
+    RemoveFiles,
+    Find,
+    Save,
+    Load,
+    Count
+};
+
+enum class StatCounter : std::uint8_t
+{
+    BytesAppended,
+    PathCacheHits,
+    NodeAllocations,
+    SlabAllocations,
+    ChunkAllocations,
+    Count
+};
+
+// Log-linear buckets: values below 8 are exact, larger ones keep three significant bits (12.5% resolution).
+class LatencyHistogram
+{
+public:
+    static constexpr unsigned subBucketBits = 3;
+    static constexpr std::size_t bucketCount = (64 - subBucketBits + 1) << subBucketBits;
+
+    std::array<std::atomic<std::uint64_t>, bucketCount> buckets{};
+    std::atomic<std::uint64_t> count{0};
+    std::atomic<std::uint64_t> sum{0};
+    std::atomic<std::uint64_t> maximum{0};
+
+    static std::size_t bucketFor(std::uint64_t value);
+    static std::uint64_t bucketUpperBound(std::size_t bucket);
+    void record(std::uint64_t value);
+    void clear();
+};
+
+// count is exact; sum and the percentiles come from the recorded samples.
+struct HistogramSummary
+{
+    std::uint64_t count = 0;
+    std::uint64_t samples = 0;
+    std::uint64_t sum = 0;
+    std::uint64_t maximum = 0;
+    std::uint64_t p50 = 0;
+    std::uint64_t p99 = 0;
+    std::uint64_t p999 = 0;
+};
+
+struct StatsSnapshot
+{
+    std::array<HistogramSummary, static_cast<std::size_t>(StatOperation::Count)> operations;
+    HistogramSummary pathDepth;
+    HistogramSummary findVisits;
+    std::array<std::uint64_t, static_cast<std::size_t>(StatCounter::Count)> counters{};
+};
+
+class Instrumentation
+{
+private:
+    struct ThreadStats
+    {
+        std::array<LatencyHistogram, static_cast<std::size_t>(StatOperation::Count)> operations;
+        std::array<std::atomic<std::uint64_t>, static_cast<std::size_t>(StatOperation::Count)> operationCounts{};
+        LatencyHistogram pathDepth;
+        LatencyHistogram findVisits;
+        std::array<std::atomic<std::uint64_t>, static_cast<std::size_t>(StatCounter::Count)> counters{};
+        std::uint64_t pendingFindVisits = 0;
+        std::uint32_t sinceLastSample = 0;
+        std::atomic<std::uint64_t> appliedReset{0};
+        std::atomic<bool> inUse{false};
+        ThreadStats *next = nullptr;
+    };
+
+    static std::atomic<std::uint32_t> samplingInterval;
+    static std::atomic<std::uint64_t> resetGeneration;
+
+    std::atomic<ThreadStats *> threads{nullptr};
+    std::uint64_t calibrationTicks;
+    std::chrono::steady_clock::time_point calibrationTime;
+
+    Instrumentation();
+    double nanosecondsPerTick();
+    ThreadStats *acquireStats();
+    static void clear(ThreadStats &stats);
+    static ThreadStats &local();
+
+    friend struct ThreadStatsHandle;
+
+public:
+#ifdef VFS_NO_INSTRUMENTATION
+    static constexpr bool enabled = false;
+#else
+    static constexpr bool enabled = true;
+#endif
+
+    Instrumentation(const Instrumentation &) = delete;
+    Instrumentation &operator=(const Instrumentation &) = delete;
+    ~Instrumentation();
+
+    static Instrumentation &instance();
+
+    // The cycle counter costs a few nanoseconds where steady_clock costs tens; ticks become nanoseconds in snapshot().
+    static std::uint64_t ticks()
+    {
+#ifdef VFS_TSC_CLOCK
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+    static void setSamplingInterval(std::uint32_t interval) { samplingInterval.store(interval == 0 ? 1 : interval, std::memory_order_relaxed); }
+    static bool sampleOperation();
+    static void recordOperation(StatOperation operation, bool sampled, std::uint64_t elapsedTicks);
+    static void recordPathDepth(std::size_t depth);
+    static void addFindVisits(std::size_t visits);
+    static void finishFind();
+    static void count(StatCounter counter, std::uint64_t amount = 1);
+
+    StatsSnapshot snapshot();
+    void reset();
+
+    static const char *operationName(StatOperation operation);
+    static const char *counterName(StatCounter counter);
+    static std::string formatTable(const StatsSnapshot &stats);
+    static std::string formatJson(const StatsSnapshot &stats);
+};
+
+class OperationTimer
+{
+private:
+    StatOperation operation;
+    bool sampled;
+    std::uint64_t started;
+
+public:
+    explicit OperationTimer(StatOperation timedOperation)
+        : operation(timedOperation), sampled(Instrumentation::sampleOperation()), started(sampled ? Instrumentation::ticks() : 0) {}
+    ~OperationTimer();
+    OperationTimer(const OperationTimer &) = delete;
+    OperationTimer &operator=(const OperationTimer &) = delete;
+};
+
+#ifdef VFS_NO_INSTRUMENTATION
+#define VFS_STATS(statement)
+#define VFS_TIME_OPERATION(operation)
+#else
+#define VFS_STATS(statement) statement
+#define VFS_TIME_OPERATION(operation) OperationTimer operationTimer(operation)
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,91 @@
+#ifndef JOURNAL_HPP
+#define JOURNAL_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "fileSystemComponent.hpp"
+#include "fsResult.hpp"
+
+// Only Always acknowledges a mutation after its record is on disk; Batch can lose up to one batch interval of
+// acknowledged mutations in a crash, and Never leaves syncing to the operating system.
+enum class SyncPolicy : std::uint8_t
+{
+    Never,
+    Batch,
+    Always
+};
+
+struct JournalOptions
+{
+    SyncPolicy syncPolicy = SyncPolicy::Batch;
+    std::chrono::milliseconds batchInterval{10};
+    std::size_t batchBytes = 1 << 20;
+    std::uint64_t compactionThreshold = 64ull << 20;
+};
+
+enum class JournalOperation : std::uint8_t
+{
+    CreateDirectory = 1,
+    CreateFile,
+    Append,
+    RemoveFiles,
+    RemoveDirectory,
+    RemoveDirectoryTree,
+    RemoveFilesRecursive
+};
+
+struct JournalRecord
+{
+    JournalOperation operation;
+    Timestamp time;
+    std::string path;
+    std::string text;
+};
+
+class Journal
+{
+private:
+    static constexpr char magic[8] = {'V', 'F', 'S', 'J', 'R', 'N', 'L', '1'};
+
+    int descriptor;
+    JournalOptions options;
+    std::mutex journalMutex;
+    std::condition_variable durableChanged;
+    std::condition_variable flushRequested;
+    std::string pendingBytes;
+    std::uint64_t appendedSequence = 0;
+    std::uint64_t durableSequence = 0;
+    std::uint64_t journalBytes;
+    bool flushing = false;
+    bool stopping = false;
+    bool healthy = true;
+    std::thread flusher;
+
+    Journal(int fileDescriptor, std::uint64_t existingBytes, const JournalOptions &journalOptions);
+    void flushPending(std::unique_lock<std::mutex> &lock);
+    void waitDurable(std::unique_lock<std::mutex> &lock, std::uint64_t sequence);
+    void runFlusher();
+
+public:
+    Journal(const Journal &) = delete;
+    Journal &operator=(const Journal &) = delete;
+    ~Journal();
+
+    static FsResult<std::unique_ptr<Journal>> open(const std::string &path, const JournalOptions &options = {});
+    static FsResult<std::size_t> replay(const std::string &path, const std::function<void(const JournalRecord &)> &apply);
+
+    bool append(const JournalRecord &record);
+    bool sync();
+    std::uint64_t size();
+};
+
+#endif
\ No newline at end of file
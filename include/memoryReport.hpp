@@ -0,0 +1,40 @@
+#ifndef MEMORYREPORT_HPP
+#define MEMORYREPORT_HPP
+
+#include <cstddef>
+#include <string>
+
+#include "directory.hpp"
+
+struct NodeMemory
+{
+    std::size_t count = 0;
+    std::size_t nodeBytes = 0;
+    std::size_t childTableBytes = 0;
+    std::size_t chunkTableBytes = 0;
+    std::size_t contentBytes = 0;
+};
+
+// Node, table and content bytes are exact; index bytes are estimated from entry counts and typical allocator rounding.
+struct MemoryReport
+{
+    NodeMemory files;
+    NodeMemory directories;
+    std::size_t inlineNames = 0;
+    std::size_t internedNames = 0;
+    std::size_t internedNameBytes = 0;
+    std::size_t nameIndexBytes = 0;
+    std::size_t timeIndexBytes = 0;
+    std::size_t extensionIndexBytes = 0;
+    std::size_t contentIndexBytes = 0;
+    std::size_t snapshotBytes = 0;
+
+    std::size_t indexBytes() const { return nameIndexBytes + timeIndexBytes + extensionIndexBytes + contentIndexBytes; }
+    std::size_t metadataBytes() const;
+    std::size_t metadataPerFile() const;
+};
+
+MemoryReport measureMemory(const Directory &root);
+std::string formatMemoryReport(const MemoryReport &report);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,43 @@
+#ifndef NAMEINDEX_HPP
+#define NAMEINDEX_HPP
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "nodeName.hpp"
+
+class File;
+class FileSystemComponent;
+
+class NameIndex
+{
+private:
+    struct NameHash
+    {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+    };
+
+    std::unordered_map<NodeName, std::unordered_set<File *>, NameHash, std::equal_to<>> filesByName;
+    std::size_t indexedFiles = 0;
+
+public:
+    void addSubtree(FileSystemComponent *component);
+    void removeSubtree(FileSystemComponent *component);
+    const std::unordered_set<File *> *find(std::string_view name) const;
+    std::size_t getIndexedFileCount() const { return indexedFiles; }
+    std::size_t getDistinctNameCount() const { return filesByName.size(); }
+
+    template <typename Visitor>
+    void forEachName(Visitor &&visitor) const
+    {
+        for (auto &entry : filesByName)
+        {
+            visitor(entry.first, entry.second);
+        }
+    }
+};
+
+#endif
\ No newline at end of file
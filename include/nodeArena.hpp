@@ -0,0 +1,80 @@
+#ifndef NODEARENA_HPP
+#define NODEARENA_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+class NodeArena : public std::pmr::memory_resource
+{
+private:
+    static constexpr std::size_t granularity = 16;
+    static constexpr std::size_t largestPooledSize = 1024;
+    static constexpr std::size_t slabSize = 64 * 1024;
+
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    std::mutex arenaMutex;
+    std::vector<std::unique_ptr<std::byte[]>> slabs;
+    std::array<FreeBlock *, largestPooledSize / granularity> freeLists{};
+    std::byte *slabCursor = nullptr;
+    std::byte *slabEnd = nullptr;
+    std::size_t liveAllocations = 0;
+    std::size_t liveLargeAllocations = 0;
+    bool released = false;
+
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void *pointer, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+public:
+    NodeArena() = default;
+    static std::size_t pooledSize(std::size_t bytes) { return bytes > largestPooledSize ? bytes : std::max((bytes + granularity - 1) / granularity * granularity, granularity); }
+    NodeArena(const NodeArena &) = delete;
+    NodeArena &operator=(const NodeArena &) = delete;
+
+    std::size_t getLiveAllocations();
+    std::size_t getReservedBytes();
+
+    // Owners give up a heap arena with release() instead of deleting it: the arena frees itself once the last
+    // allocation is returned, so nodes handed out as shared_ptrs may outlive the file system that made them.
+    void release();
+
+    struct Releaser
+    {
+        void operator()(NodeArena *arena) const { arena->release(); }
+    };
+};
+
+// Holds a raw pointer to keep control blocks small; a released arena stays alive until its last allocation is freed.
+template <typename T>
+class ArenaAllocator
+{
+private:
+    NodeArena *arena;
+
+    template <typename U>
+    friend class ArenaAllocator;
+
+public:
+    using value_type = T;
+
+    ArenaAllocator(NodeArena *nodeArena) : arena(nodeArena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {}
+
+    T *allocate(std::size_t count) { return static_cast<T *>(arena->allocate(count * sizeof(T), alignof(T))); }
+    void deallocate(T *pointer, std::size_t count) { arena->deallocate(pointer, count * sizeof(T), alignof(T)); }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U> &other) const { return arena == other.arena; }
+};
+
+#endif
\ No newline at end of file
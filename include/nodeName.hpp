@@ -0,0 +1,136 @@
+#ifndef NODENAME_HPP
+#define NODENAME_HPP
+
+#include <atomic>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+class NameInterner
+{
+public:
+    struct Entry
+    {
+        mutable std::atomic<std::uint32_t> references{1};
+        std::uint32_t length;
+        std::size_t hash;
+
+        const char *characters() const { return reinterpret_cast<const char *>(this + 1); }
+        std::string_view view() const { return std::string_view(characters(), length); }
+    };
+
+private:
+    struct EntryHash
+    {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+        std::size_t operator()(const Entry *entry) const { return entry->hash; }
+    };
+    struct EntryEqual
+    {
+        using is_transparent = void;
+        static std::string_view key(std::string_view name) { return name; }
+        static std::string_view key(const Entry *entry) { return entry->view(); }
+        template <typename Left, typename Right>
+        bool operator()(const Left &left, const Right &right) const { return key(left) == key(right); }
+    };
+    struct Shard
+    {
+        std::mutex mutex;
+        std::unordered_set<const Entry *, EntryHash, EntryEqual> entries;
+        std::size_t bytes = 0;
+    };
+
+    static constexpr std::size_t shardCount = 16;
+    Shard shards[shardCount];
+
+    NameInterner() = default;
+
+public:
+    NameInterner(const NameInterner &) = delete;
+    NameInterner &operator=(const NameInterner &) = delete;
+
+    static NameInterner &instance();
+    static std::size_t entryFootprint(std::size_t length) { return sizeof(Entry) + length; }
+
+    const Entry *acquire(std::string_view name);
+    void release(const Entry *entry);
+    std::size_t internedCount();
+    std::size_t internedBytes();
+};
+
+// Names of up to 15 bytes live inline; longer ones point at a shared, reference-counted interned copy.
+class NodeName
+{
+private:
+    static constexpr std::size_t inlineCapacity = 15;
+    static constexpr unsigned char internedTag = 0xff;
+
+    union
+    {
+        char inlineCharacters[inlineCapacity + 1];
+        const NameInterner::Entry *interned;
+    };
+
+    unsigned char &tag() { return reinterpret_cast<unsigned char &>(inlineCharacters[inlineCapacity]); }
+    unsigned char tag() const { return static_cast<unsigned char>(inlineCharacters[inlineCapacity]); }
+    void assign(std::string_view name);
+    void releaseInterned()
+    {
+        if (isInterned())
+        {
+            NameInterner::instance().release(interned);
+        }
+    }
+
+public:
+    NodeName() { std::memset(inlineCharacters, 0, sizeof(inlineCharacters)); }
+    NodeName(std::string_view name) { assign(name); }
+    NodeName(const std::string &name) : NodeName(std::string_view(name)) {}
+    NodeName(const char *name) : NodeName(std::string_view(name)) {}
+    NodeName(const NodeName &other)
+    {
+        std::memcpy(inlineCharacters, other.inlineCharacters, sizeof(inlineCharacters));
+        if (isInterned())
+        {
+            interned->references.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    NodeName(NodeName &&other) noexcept
+    {
+        std::memcpy(inlineCharacters, other.inlineCharacters, sizeof(inlineCharacters));
+        std::memset(other.inlineCharacters, 0, sizeof(other.inlineCharacters));
+    }
+    NodeName &operator=(NodeName other) noexcept
+    {
+        releaseInterned();
+        std::memcpy(inlineCharacters, other.inlineCharacters, sizeof(inlineCharacters));
+        std::memset(other.inlineCharacters, 0, sizeof(other.inlineCharacters));
+        return *this;
+    }
+    ~NodeName() { releaseInterned(); }
+
+    bool isInterned() const { return tag() == internedTag; }
+    const NameInterner::Entry *internedEntry() const { return isInterned() ? interned : nullptr; }
+    std::size_t size() const { return isInterned() ? interned->length : tag(); }
+    bool empty() const { return size() == 0; }
+    std::string_view view() const { return isInterned() ? interned->view() : std::string_view(inlineCharacters, tag()); }
+    std::string str() const { return std::string(view()); }
+    operator std::string_view() const { return view(); }
+
+    friend bool operator==(const NodeName &left, const NodeName &right) { return left.view() == right.view(); }
+    friend bool operator==(const NodeName &left, std::string_view right) { return left.view() == right; }
+    friend bool operator==(const NodeName &left, const std::string &right) { return left.view() == right; }
+    friend bool operator==(const NodeName &left, const char *right) { return left.view() == right; }
+    friend std::strong_ordering operator<=>(const NodeName &left, const NodeName &right) { return left.view() <=> right.view(); }
+    friend std::strong_ordering operator<=>(const NodeName &left, std::string_view right) { return left.view() <=> right; }
+    friend std::string operator+(std::string left, const NodeName &right) { return left.append(right.view()); }
+    friend std::ostream &operator<<(std::ostream &stream, const NodeName &name) { return stream << name.view(); }
+};
+
+#endif
\ No newline at end of file
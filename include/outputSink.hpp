@@ -0,0 +1,107 @@
+#ifndef OUTPUTSINK_HPP
+#define OUTPUTSINK_HPP
+
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class OutputSink
+{
+public:
+    virtual ~OutputSink() = default;
+    virtual void write(std::string_view text) = 0;
+    virtual void flush() {}
+
+    OutputSink &operator<<(std::string_view text)
+    {
+        write(text);
+        return *this;
+    }
+    OutputSink &operator<<(char character)
+    {
+        write(std::string_view(&character, 1));
+        return *this;
+    }
+};
+
+class BufferedStreamSink : public OutputSink
+{
+private:
+    std::ostream &stream;
+    std::string buffer;
+    std::size_t capacity;
+
+public:
+    explicit BufferedStreamSink(std::ostream &outputStream = std::cout, std::size_t bufferCapacity = 64 * 1024)
+        : stream(outputStream), capacity(bufferCapacity) {}
+    ~BufferedStreamSink() override { flush(); }
+
+    void write(std::string_view text) override;
+    void flush() override;
+};
+
+class VectorSink : public OutputSink
+{
+private:
+    std::vector<std::string> lines;
+    std::string pendingLine;
+
+public:
+    void write(std::string_view text) override;
+    void flush() override;
+    const std::vector<std::string> &getLines() const { return lines; }
+    void clear();
+};
+
+class FileDescriptorSink : public OutputSink
+{
+private:
+    int fileDescriptor;
+    std::string buffer;
+    std::size_t capacity;
+
+public:
+    explicit FileDescriptorSink(int descriptor, std::size_t bufferCapacity = 64 * 1024)
+        : fileDescriptor(descriptor), capacity(bufferCapacity) {}
+    ~FileDescriptorSink() override { flush(); }
+
+    void write(std::string_view text) override;
+    void flush() override;
+};
+
+class DiscardSink : public OutputSink
+{
+public:
+    void write(std::string_view) override {}
+};
+
+class DeferredFlushSink : public OutputSink
+{
+private:
+    std::shared_ptr<OutputSink> target;
+
+public:
+    explicit DeferredFlushSink(std::shared_ptr<OutputSink> targetSink) : target(std::move(targetSink)) {}
+    ~DeferredFlushSink() override { drain(); }
+
+    void write(std::string_view text) override { target->write(text); }
+    void flush() override {}
+    void drain() { target->flush(); }
+};
+
+class SinkFlushGuard
+{
+private:
+    OutputSink &sink;
+
+public:
+    explicit SinkFlushGuard(OutputSink &outputSink) : sink(outputSink) {}
+    SinkFlushGuard(const SinkFlushGuard &) = delete;
+    SinkFlushGuard &operator=(const SinkFlushGuard &) = delete;
+    ~SinkFlushGuard() { sink.flush(); }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,83 @@
+#ifndef PATHRESOLVER_HPP
+#define PATHRESOLVER_HPP
+
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "directory.hpp"
+
+class PathTokenizer
+{
+private:
+    std::string_view path;
+    std::size_t position = 0;
+
+public:
+    PathTokenizer(std::string_view pathToSplit) : path(pathToSplit) {}
+    bool isAbsolute() const;
+    bool next(std::string_view &segment);
+};
+
+struct ResolvedPath
+{
+    FileSystemComponent *component = nullptr;
+    std::string_view missingSegment;
+    bool invalidLeaf = false;
+};
+
+class PathResolver
+{
+private:
+    struct CacheKey
+    {
+        const Directory *baseDirectory;
+        std::string path;
+    };
+    struct CacheKeyView
+    {
+        const Directory *baseDirectory;
+        std::string_view path;
+    };
+    struct CacheKeyHash
+    {
+        using is_transparent = void;
+        std::size_t operator()(const CacheKeyView &key) const;
+        std::size_t operator()(const CacheKey &key) const { return (*this)(CacheKeyView{key.baseDirectory, key.path}); }
+    };
+    struct CacheKeyEqual
+    {
+        using is_transparent = void;
+        template <typename Left, typename Right>
+        bool operator()(const Left &left, const Right &right) const
+        {
+            return left.baseDirectory == right.baseDirectory && std::string_view(left.path) == std::string_view(right.path);
+        }
+    };
+    struct CacheEntry
+    {
+        CacheKey key;
+        std::weak_ptr<Directory> baseDirectory;
+        std::uint64_t generation;
+        FileSystemComponent *component;
+    };
+
+    std::size_t capacity;
+    std::list<CacheEntry> recentlyUsed;
+    std::unordered_map<CacheKey, std::list<CacheEntry>::iterator, CacheKeyHash, CacheKeyEqual> cache;
+
+    ResolvedPath walk(std::string_view path, Directory *rootDirectory, Directory *baseDirectory);
+    FileSystemComponent *findCached(std::string_view path, Directory *baseDirectory);
+    void storeCached(std::string_view path, Directory *baseDirectory, FileSystemComponent *component);
+
+public:
+    PathResolver(std::size_t cacheCapacity = 1024) : capacity(cacheCapacity) {}
+
+    ResolvedPath resolve(std::string_view path, Directory *rootDirectory, Directory *baseDirectory);
+    ResolvedPath resolveParent(std::string_view path, Directory *rootDirectory, Directory *baseDirectory, std::string_view &leafName);
+    std::size_t cachedPaths() const { return cache.size(); }
+    void clear();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,42 @@
+#ifndef SESSION_HPP
+#define SESSION_HPP
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "fileSystem.hpp"
+
+class Session
+{
+private:
+    struct WalkedPath
+    {
+        std::vector<std::shared_ptr<Directory>> directories;
+        std::vector<std::string> names;
+    };
+
+    FileSystem &fileSystem;
+    WalkedPath workingPath;
+
+    FsResult<> walk(std::string_view path, bool stopBeforeLeaf, WalkedPath &walked, std::string &leafName) const;
+    static std::string pathString(const WalkedPath &walked);
+
+public:
+    explicit Session(FileSystem &sharedFileSystem);
+
+    std::string getWorkingPath() const { return pathString(workingPath); }
+    const std::shared_ptr<Directory> &getWorkingDirectory() const { return workingPath.directories.back(); }
+    FsResult<> changeDirectory(const std::string &path);
+    FsResult<> createDirectory(const std::string &path);
+    FsResult<> createFile(const std::string &path);
+    FsResult<> appendToFile(const std::string &path, const std::string &text);
+    FsResult<std::string> readFile(const std::string &path) const;
+    FsResult<std::vector<std::string>> listDirectory(const std::string &path = "", const ListingCursor &cursor = {}, const std::string &pattern = "") const;
+    FsResult<> removeDirectory(const std::string &path, bool recursive = false);
+    FsResult<std::size_t> removeFiles(const std::string &pattern);
+    FsResult<std::vector<std::string>> find(const FindQuery &query) const;
+};
+
+#endif
\ No newline at end of file
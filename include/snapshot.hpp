@@ -0,0 +1,69 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "directory.hpp"
+#include "fsResult.hpp"
+
+class FileSystem;
+
+struct SnapshotHeader
+{
+    static constexpr char expectedMagic[8] = {'V', 'F', 'S', 'S', 'N', 'A', 'P', '\0'};
+    static constexpr std::uint32_t currentVersion = 1;
+    static constexpr std::uint32_t nativeByteOrder = 0x01020304;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint64_t nodeCount;
+    std::uint64_t nodeTableOffset;
+    std::uint64_t stringPoolOffset;
+    std::uint64_t stringPoolSize;
+    std::uint64_t contentOffset;
+    std::uint64_t contentSize;
+};
+
+struct SnapshotNode
+{
+    std::uint64_t parentIndex;
+    std::uint64_t nameOffset;
+    std::uint64_t contentOffset;
+    std::uint64_t contentLength;
+    std::int64_t creationTime;
+    std::int64_t modificationTime;
+    std::uint32_t nameLength;
+    NodeKind kind;
+    std::uint8_t padding[3];
+};
+
+static_assert(sizeof(SnapshotHeader) == 64);
+static_assert(sizeof(SnapshotNode) == 56);
+
+class MappedFile
+{
+private:
+    void *address = nullptr;
+    std::size_t length = 0;
+
+    MappedFile(void *mappedAddress, std::size_t mappedLength) : address(mappedAddress), length(mappedLength) {}
+
+public:
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    ~MappedFile();
+
+    static FsResult<std::shared_ptr<MappedFile>> open(const std::string &path);
+    std::string_view bytes() const { return std::string_view(static_cast<const char *>(address), length); }
+};
+
+bool syncToDisk(const std::string &path);
+FsResult<std::size_t> writeSnapshot(Directory &root, const std::string &path);
+FsResult<std::shared_ptr<Directory>> readSnapshot(const std::string &path, FileSystem &fileSystem);
+
+#endif
\ No newline at end of file
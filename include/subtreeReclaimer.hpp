@@ -0,0 +1,49 @@
+#ifndef SUBTREERECLAIMER_HPP
+#define SUBTREERECLAIMER_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "fileSystemComponent.hpp"
+#include "treeContext.hpp"
+
+// Tears down detached subtrees on a background thread: index entries are removed in batches, then the nodes are freed without recursion.
+class SubtreeReclaimer
+{
+private:
+    struct Job
+    {
+        std::shared_ptr<FileSystemComponent> root;
+        std::shared_ptr<TreeContext> context;
+    };
+
+    std::mutex queueMutex;
+    std::condition_variable jobQueued;
+    std::condition_variable jobsFinished;
+    std::deque<Job> pendingJobs;
+    bool working = false;
+    bool stopping = false;
+    std::size_t reclaimedNodes = 0;
+    std::thread worker;
+
+    void runWorker();
+
+public:
+    static constexpr std::size_t indexBatchSize = 4096;
+
+    SubtreeReclaimer() = default;
+    SubtreeReclaimer(const SubtreeReclaimer &) = delete;
+    SubtreeReclaimer &operator=(const SubtreeReclaimer &) = delete;
+    ~SubtreeReclaimer();
+
+    static std::size_t reclaim(std::shared_ptr<FileSystemComponent> root, TreeContext *context);
+    void submit(std::shared_ptr<FileSystemComponent> root, std::shared_ptr<TreeContext> context);
+    void drain();
+    std::size_t getReclaimedNodeCount();
+};
+
+#endif
\ No newline at end of file
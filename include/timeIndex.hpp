@@ -0,0 +1,50 @@
+#ifndef TIMEINDEX_HPP
+#define TIMEINDEX_HPP
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <utility>
+
+#include "fileSystemComponent.hpp"
+
+class File;
+
+// Sharded by file address so appends to different files update the index without a tree-wide lock.
+class TimeIndex
+{
+private:
+    static constexpr std::size_t shardCount = 16;
+
+    struct alignas(64) Shard
+    {
+        mutable std::mutex mutex;
+        std::set<std::pair<Timestamp, File *>> filesByModificationTime;
+    };
+
+    std::array<Shard, shardCount> shards;
+
+    Shard &shardFor(const File *file) { return shards[(reinterpret_cast<std::uintptr_t>(file) >> 4) % shardCount]; }
+
+public:
+    void addSubtree(FileSystemComponent *component);
+    void removeSubtree(FileSystemComponent *component);
+    void update(File *file, Timestamp previousTime, Timestamp currentTime);
+    std::size_t getIndexedFileCount() const;
+
+    template <typename Visitor>
+    void forEachModifiedSince(Timestamp cutoff, Visitor &&visitor) const
+    {
+        for (const Shard &shard : shards)
+        {
+            std::lock_guard<std::mutex> shardLock(shard.mutex);
+            for (auto entry = shard.filesByModificationTime.lower_bound({cutoff, nullptr}); entry != shard.filesByModificationTime.end(); ++entry)
+            {
+                visitor(entry->second);
+            }
+        }
+    }
+};
+
+#endif
\ No newline at end of file
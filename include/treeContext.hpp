@@ -0,0 +1,37 @@
+#ifndef TREECONTEXT_HPP
+#define TREECONTEXT_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+
+#include "contentIndex.hpp"
+#include "nameIndex.hpp"
+#include "timeIndex.hpp"
+
+struct TreeContext
+{
+    static constexpr std::size_t contentLockStripes = 64;
+
+    struct alignas(64) ContentLock
+    {
+        std::shared_mutex mutex;
+    };
+
+    std::atomic<std::uint64_t> generation{0};
+    std::shared_mutex indexMutex;
+    NameIndex nameIndex;
+    TimeIndex timeIndex;
+    std::unique_ptr<ContentIndex> contentIndex;
+
+    static std::shared_mutex &contentMutexFor(const File *file)
+    {
+        static std::array<ContentLock, contentLockStripes> contentLocks;
+        return contentLocks[(reinterpret_cast<std::uintptr_t>(file) >> 4) % contentLockStripes].mutex;
+    }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,51 @@
+#ifndef WORKSTEALINGPOOL_HPP
+#define WORKSTEALINGPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkStealingPool
+{
+public:
+    using Task = std::function<void()>;
+
+private:
+    struct WorkerQueue
+    {
+        std::mutex queueMutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<std::size_t> queuedTasks{0};
+    std::atomic<std::size_t> pendingTasks{0};
+    std::atomic<std::size_t> nextQueue{0};
+    std::mutex sleepMutex;
+    std::condition_variable wakeWorkers;
+    std::condition_variable allTasksDone;
+    bool stopping = false;
+
+    bool popLocal(std::size_t workerIndex, Task &task);
+    bool steal(std::size_t workerIndex, Task &task);
+    void workerLoop(std::size_t workerIndex);
+
+public:
+    WorkStealingPool(std::size_t threadCount);
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+    ~WorkStealingPool();
+
+    std::size_t getThreadCount() const { return workers.size(); }
+    static int currentWorker();
+    void submit(Task task);
+    void wait();
+};
+
+#endif
\ No newline at end of file
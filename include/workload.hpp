@@ -0,0 +1,90 @@
+#ifndef WORKLOAD_HPP
+#define WORKLOAD_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "commandExecutor.hpp"
+#include "commandScript.hpp"
+#include "fileSystem.hpp"
+
+class SeededRandom
+{
+private:
+    std::uint64_t state;
+
+public:
+    explicit SeededRandom(std::uint64_t seed) : state(seed) {}
+
+    std::uint64_t next();
+    std::uint64_t uniform(std::uint64_t low, std::uint64_t high);
+    double unit();
+    double exponential(double mean);
+};
+
+enum class DistributionKind : std::uint8_t
+{
+    Fixed,
+    Uniform,
+    Exponential
+};
+
+// Fixed draws low, Uniform draws from [low, high], Exponential has mean low and is capped at high.
+struct Distribution
+{
+    DistributionKind kind = DistributionKind::Fixed;
+    std::uint64_t low = 0;
+    std::uint64_t high = 0;
+
+    std::uint64_t sample(SeededRandom &random) const;
+};
+
+struct TreeShape
+{
+    std::uint64_t seed = 1;
+    int depth = 4;
+    Distribution directoriesPerDirectory{DistributionKind::Uniform, 1, 6};
+    Distribution filesPerDirectory{DistributionKind::Uniform, 0, 16};
+    Distribution fileSize{DistributionKind::Exponential, 1024, 1 << 20};
+    std::string directoryPattern = "dir{n}";
+    std::string filePattern = "file{n}.txt";
+    std::size_t maxNodes = 1 << 20;
+};
+
+struct GeneratedTree
+{
+    std::vector<std::string> directories;
+    std::vector<std::string> files;
+    std::uint64_t contentBytes = 0;
+};
+
+struct WorkloadMix
+{
+    unsigned cd = 20;
+    unsigned ls = 20;
+    unsigned cat = 35;
+    unsigned find = 5;
+    unsigned echo = 15;
+    unsigned rm = 5;
+};
+
+struct ReplayReport
+{
+    std::size_t commands = 0;
+    std::chrono::nanoseconds elapsed{0};
+    std::chrono::nanoseconds p50{0};
+    std::chrono::nanoseconds p99{0};
+    std::chrono::nanoseconds p999{0};
+    std::chrono::nanoseconds maximum{0};
+
+    double throughput() const;
+};
+
+GeneratedTree generateTree(FileSystem &fileSystem, const TreeShape &shape);
+std::string generateWorkload(const GeneratedTree &tree, const WorkloadMix &mix, std::size_t commandCount, std::uint64_t seed);
+ReplayReport replayWorkload(CommandExecutor &commandExecutor, const CommandScript &script, double arrivalRate, std::uint64_t seed);
+
+#endif
\ No newline at end of file
@@ -1,12 +1,73 @@
+#include <fstream>
 #include <iostream>
 #include <memory>
+#include <string>
+#include <string_view>
 
 #include "commandExecutor.hpp"
 
-int main()
+int main(int argc, char *argv[])
 {
-    CommandExecutor *commandExecutorObject = new CommandExecutor();
-    commandExecutorObject->readCommandLine();
+    std::shared_ptr<FileSystem> fileSystem = std::make_shared<FileSystem>();
+    bool batchMode = false;
+    const char *scriptPath = nullptr;
+    const char *journalDirectory = nullptr;
+    for (int index = 1; index < argc; ++index)
+    {
+        std::string_view argument = argv[index];
+        if (argument == "--batch")
+        {
+            batchMode = true;
+        }
+        else if (argument == "--script" && index + 1 < argc)
+        {
+            batchMode = true;
+            scriptPath = argv[++index];
+        }
+        else if (!argument.starts_with("--") && journalDirectory == nullptr)
+        {
+            journalDirectory = argv[index];
+        }
+        else
+        {
+            std::cerr << (argument == "--script" ? "Missing script path after --script" : "Unknown argument: " + std::string(argument)) << '\n'
+                      << "Usage: " << argv[0] << " [--batch] [--script <file>] [journal-directory]" << std::endl;
+            return 2;
+        }
+    }
+    if (journalDirectory != nullptr)
+    {
+        FsResult<std::size_t> replayed = fileSystem->openJournal(journalDirectory);
+        if (!replayed.ok())
+        {
+            std::cerr << "Cannot open journal: " << replayed.detail << " (" << describeStatus(replayed.status) << ")" << std::endl;
+            return 1;
+        }
+    }
+    CommandExecutor *commandExecutorObject = new CommandExecutor(fileSystem);
+    if (batchMode)
+    {
+        std::ios::sync_with_stdio(false);
+        if (scriptPath != nullptr)
+        {
+            std::ifstream script(scriptPath, std::ios::binary);
+            if (!script)
+            {
+                std::cerr << "Cannot open script: " << scriptPath << std::endl;
+                delete commandExecutorObject;
+                return 1;
+            }
+            commandExecutorObject->runBatch(script);
+        }
+        else
+        {
+            commandExecutorObject->runBatch(std::cin);
+        }
+    }
+    else
+    {
+        commandExecutorObject->readCommandLine();
+    }
     
     delete commandExecutorObject;
 }
\ No newline at end of file